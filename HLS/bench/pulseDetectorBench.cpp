@@ -0,0 +1,221 @@
+#include "../common/iqCapture.hpp"
+#ifdef BENCH_HOST_MODEL
+#include "../host/pulseDetectorModel.hpp"
+#include "../host/templateTaps.hpp"
+#else
+#include "pulseDetector.hpp"
+#endif
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Benchmark harness, built once per variant and frame length by runBench.py:
+//   g++ -O2 -I<variant dir> -I<HLS include> -DSIGNAL_LENGTH=N pulseDetectorBench.cpp <variant dir>/pulseDetector.cpp
+// or, for the host model, with -DBENCH_HOST_MODEL -DBENCH_HOST_ARCH=ARCH_THREE_REAL
+// and ../host/pulseDetectorModel.cpp. Every build generates the same frames,
+// so the reported locations can be compared across variants.
+//
+// Usage: pulseDetectorBench <name> <stimulus dir> <frames> <min seconds>
+// Prints one CSV row per stimulus:
+//   variant,signal_length,stimulus,frames,ns_per_sample,frames_per_s,peak_rss_kb,locations
+
+using namespace std;
+
+#ifdef BENCH_HOST_MODEL
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+const detector::model::model_arch hostArch = detector::model::BENCH_HOST_ARCH;
+#endif
+
+// Samples of the recorded pulse copied into the synthetic frames, ending at
+// the reference location
+#define PULSE_SPAN 128
+
+static unsigned lcgNext(unsigned& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// Recorded capture, a circular window around the pulse that moves with k
+static void recordedFrame(const detector::iq_capture& capture, int pulse, int k, vector<int32_t>& iq) {
+    const long num_samples = (long)capture.numSamples();
+    long start = ((long)pulse - SIGNAL_LENGTH / 2 + 61L * k) % num_samples;
+    if (start < 0) {
+        start += num_samples;
+    }
+    iq.resize(2 * SIGNAL_LENGTH);
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        long src = (start + n) % num_samples;
+        iq[2 * n] = capture.data()[2 * src];
+        iq[2 * n + 1] = capture.data()[2 * src + 1];
+    }
+}
+
+// Low-level uniform noise with the recorded pulse pasted at a pseudo-random offset
+static void syntheticFrame(const detector::iq_capture& capture, int pulse, int k, vector<int32_t>& iq) {
+    unsigned state = 12345u + 977u * k;
+    iq.resize(2 * SIGNAL_LENGTH);
+    for (int n = 0; n < 2 * SIGNAL_LENGTH; n++) {
+        iq[n] = (int32_t)(lcgNext(state) & 0xfff) - 0x800; // about +-0.03
+    }
+    int offset = PULSE_SPAN + (int)(lcgNext(state) % (SIGNAL_LENGTH - 2 * PULSE_SPAN));
+    for (int n = 0; n < PULSE_SPAN; n++) {
+        long src = pulse - PULSE_SPAN + 1 + n;
+        iq[2 * (offset + n)] = capture.data()[2 * src];
+        iq[2 * (offset + n) + 1] = capture.data()[2 * src + 1];
+    }
+}
+
+// Peak resident set of this process in kB. VmHWM rather than ru_maxrss,
+// which keeps the parent's high-water mark across fork and exec on Linux
+static long peakRssKb() {
+    ifstream status("/proc/self/status");
+    string key;
+    long value;
+    while (status >> key) {
+        if (key == "VmHWM:" && status >> value) {
+            return value;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+#ifdef BENCH_HOST_MODEL
+static detector::model::pulse_detector_model* hostModel;
+
+static int detect(const int32_t* iq) {
+    int32_t peak;
+    int location;
+    hostModel->pulseDetector(iq, iq + 1, SIGNAL_LENGTH, peak, location, 2);
+    return location;
+}
+#else
+static complex_fixed_point corrFilterArray[FILTER_LENGTH];
+
+// origin and resource_opt1 take the template with every frame
+static void runFrame(void (*top)(complex_stream&, complex_stream&, fixed_point&, int&), complex_stream& RxSignal,
+                     fixed_point& peak, int& location) {
+    complex_stream CorrFilter;
+    for (int j = 0; j < FILTER_LENGTH; j++) {
+        CorrFilter.write(corrFilterArray[j]);
+    }
+    top(RxSignal, CorrFilter, peak, location);
+}
+
+static void runFrame(void (*top)(complex_stream&, fixed_point&, int&), complex_stream& RxSignal, fixed_point& peak,
+                     int& location) {
+    top(RxSignal, peak, location);
+}
+
+static int detect(const int32_t* iq) {
+    complex_stream RxSignal;
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        RxSignal.write(complex_fixed_point(fixed_point(detector::iqValue(iq[2 * n])),
+                                           fixed_point(detector::iqValue(iq[2 * n + 1]))));
+    }
+    fixed_point peak;
+    int location;
+    runFrame(pulseDetector, RxSignal, peak, location);
+    return location;
+}
+#endif
+
+int main(int argc, char** argv) {
+    if (argc != 5) {
+        cerr << "Usage: " << argv[0] << " <name> <stimulus dir> <frames> <min seconds>" << endl;
+        return 1;
+    }
+    const string name = argv[1];
+    const string dir = argv[2];
+    const int num_frames = atoi(argv[3]);
+    const double min_seconds = atof(argv[4]);
+
+    if (SIGNAL_LENGTH < 2 * PULSE_SPAN + 1 || num_frames < 1) {
+        cerr << "SIGNAL_LENGTH must be at least " << 2 * PULSE_SPAN + 1 << endl;
+        return 1;
+    }
+
+    detector::iq_capture capture;
+    if (!detector::openCapture(capture, "RxSignal_in.iq", dir + "/RxSignal_in.txt", 0)) {
+        cerr << "Error opening " << dir << "/RxSignal_in.txt" << endl;
+        return 1;
+    }
+    int location_ref;
+    ifstream location_file((dir + "/location_out.txt").c_str());
+    if (!(location_file >> location_ref)) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    const int pulse = location_ref - 1;
+
+#ifdef BENCH_HOST_MODEL
+    double taps[detector::model::TEMPLATE_TAPS][3];
+    if (hostArch == detector::model::ARCH_FIR_IP) {
+        detector::model::firTaps(0, taps);
+    } else {
+        for (int j = 0; j < detector::model::TEMPLATE_TAPS; j++) {
+            for (int k = 0; k < 3; k++) {
+                taps[j][k] = detector::model::threeRealTaps[j][k];
+            }
+        }
+    }
+    hostModel = new detector::model::pulse_detector_model(taps, detector::model::TEMPLATE_TAPS, hostArch);
+#else
+    FILE* corr_file = fopen((dir + "/CorrFilter_in.txt").c_str(), "r");
+    if (corr_file == NULL) {
+        cerr << "Error opening CorrFilter_in.txt" << endl;
+        return 1;
+    }
+    for (int j = 0; j < FILTER_LENGTH; j++) {
+        double real_part, imag_part;
+        if (fscanf(corr_file, "%lf %lf", &real_part, &imag_part) != 2) {
+            cerr << "Short CorrFilter_in.txt" << endl;
+            return 1;
+        }
+        corrFilterArray[j] = complex_fixed_point(fixed_point(real_part), fixed_point(imag_part));
+    }
+    fclose(corr_file);
+#endif
+
+    const char* stimulusNames[2] = {"recorded", "synthetic"};
+    vector<vector<int32_t> > frames(num_frames);
+    for (int s = 0; s < 2; s++) {
+        for (int k = 0; k < num_frames; k++) {
+            if (s == 0) {
+                recordedFrame(capture, pulse, k, frames[k]);
+            } else {
+                syntheticFrame(capture, pulse, k, frames[k]);
+            }
+        }
+
+        // Untimed pass for the locations, then whole passes until min_seconds
+        string locations;
+        for (int k = 0; k < num_frames; k++) {
+            locations += (k ? ";" : "") + to_string(detect(frames[k].data()));
+        }
+        long timed_frames = 0;
+        double seconds = 0;
+        auto t0 = chrono::steady_clock::now();
+        do {
+            for (int k = 0; k < num_frames; k++) {
+                detect(frames[k].data());
+            }
+            timed_frames += num_frames;
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        } while (seconds < min_seconds);
+
+        cout << name << "," << SIGNAL_LENGTH << "," << stimulusNames[s] << "," << timed_frames << ","
+             << seconds * 1e9 / ((double)timed_frames * SIGNAL_LENGTH) << "," << timed_frames / seconds << ","
+             << peakRssKb() << "," << locations << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Cross-variant throughput benchmark of the csim models and the host model.
+
+Builds pulseDetectorBench.cpp once per variant and frame length against the
+HLS headers (ap_fixed, hls_stream; resource_opt4 also needs hls_fir.h) and
+runs each build over the same recorded and synthetic frames. Every variant
+runs in its own process, so peak RSS is per variant. Results are written as
+CSV (and optionally JSON). The script exits non-zero if the variants disagree
+on any location or, with --baseline, if a variant got slower than the
+tolerance allows.
+
+    python3 runBench.py --hls-include $XILINX_HLS/include --out bench.csv
+    python3 runBench.py --baseline bench.csv --tolerance 0.15
+"""
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+HLS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BENCH_SOURCE = os.path.join(HLS_DIR, 'bench', 'pulseDetectorBench.cpp')
+STIMULUS_DIR = os.path.join(HLS_DIR, 'resource_opt3')
+
+CSIM_VARIANTS = ['origin', 'resource_opt1', 'resource_opt2', 'resource_opt3', 'resource_opt4', 'resource_opt7']
+HOST_VARIANTS = {'host_three_real': 'ARCH_THREE_REAL', 'host_fir_ip': 'ARCH_FIR_IP'}
+
+FIELDS = ['variant', 'signal_length', 'stimulus', 'frames', 'ns_per_sample', 'frames_per_s', 'peak_rss_kb',
+          'locations']
+
+
+def build(args, variant, length):
+    out_dir = os.path.join(args.build_dir, '%s_%d' % (variant, length))
+    os.makedirs(out_dir, exist_ok=True)
+    exe = os.path.join(out_dir, 'bench')
+    cmd = [args.cxx, '-std=c++14', '-O3' if variant in HOST_VARIANTS else '-O2', '-Wno-unknown-pragmas',
+           '-DSIGNAL_LENGTH=%d' % length]
+    if variant in HOST_VARIANTS:
+        cmd += ['-DBENCH_HOST_MODEL', '-DBENCH_HOST_ARCH=' + HOST_VARIANTS[variant], BENCH_SOURCE,
+                os.path.join(HLS_DIR, 'host', 'pulseDetectorModel.cpp')]
+    else:
+        variant_dir = os.path.join(HLS_DIR, variant)
+        cmd += ['-I' + variant_dir, '-I' + args.hls_include, BENCH_SOURCE,
+                os.path.join(variant_dir, 'pulseDetector.cpp')]
+    cmd += ['-o', exe]
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        raise RuntimeError('build of %s (SIGNAL_LENGTH %d) failed' % (variant, length))
+    return exe, out_dir
+
+
+def run(args, variant, length):
+    exe, out_dir = build(args, variant, length)
+    # The binary capture is converted into the build directory on first use
+    result = subprocess.run([exe, variant, STIMULUS_DIR, str(args.frames), str(args.min_time)], cwd=out_dir,
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    rows = []
+    for line in result.stdout.splitlines():
+        values = line.split(',')
+        if len(values) == len(FIELDS):
+            rows.append(dict(zip(FIELDS, values)))
+    return rows
+
+
+def cross_check(rows):
+    """Every variant must report the same location for every frame."""
+    errors = []
+    reference = {}
+    for row in rows:
+        key = (row['signal_length'], row['stimulus'])
+        if key not in reference:
+            reference[key] = row
+            continue
+        expected = reference[key]['locations'].split(';')
+        actual = row['locations'].split(';')
+        for frame, (a, b) in enumerate(zip(expected, actual)):
+            if a != b:
+                errors.append('%s vs %s, SIGNAL_LENGTH %s, %s frame %d: location %s != %s' %
+                              (row['variant'], reference[key]['variant'], key[0], key[1], frame, b, a))
+    return errors
+
+
+def compare_baseline(rows, path, tolerance):
+    """Rows whose ns/sample grew by more than tolerance against the baseline CSV."""
+    with open(path) as f:
+        baseline = {(r['variant'], r['signal_length'], r['stimulus']): r for r in csv.DictReader(f)}
+    regressions = []
+    for row in rows:
+        old = baseline.get((row['variant'], row['signal_length'], row['stimulus']))
+        if old is None:
+            continue
+        ratio = float(row['ns_per_sample']) / float(old['ns_per_sample'])
+        if ratio > 1 + tolerance:
+            regressions.append('%s, SIGNAL_LENGTH %s, %s: %.1f -> %.1f ns/sample (+%.0f%%)' %
+                               (row['variant'], row['signal_length'], row['stimulus'], float(old['ns_per_sample']),
+                                float(row['ns_per_sample']), (ratio - 1) * 100))
+    return regressions
+
+
+def main():
+    xilinx_hls = os.environ.get('XILINX_HLS')
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--variants', default=','.join(CSIM_VARIANTS + list(HOST_VARIANTS)),
+                        help='comma-separated variant directories and host_three_real/host_fir_ip')
+    parser.add_argument('--lengths', default='1024,5000,16384', help='comma-separated SIGNAL_LENGTH values')
+    parser.add_argument('--frames', type=int, default=8, help='distinct frames per stimulus')
+    parser.add_argument('--min-time', type=float, default=1.0, help='minimum timed seconds per stimulus')
+    parser.add_argument('--hls-include', default=os.path.join(xilinx_hls, 'include') if xilinx_hls else None,
+                        help='directory with ap_fixed.h and hls_stream.h (default $XILINX_HLS/include)')
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'g++'))
+    parser.add_argument('--build-dir', default='bench_build')
+    parser.add_argument('--out', help='CSV results (default stdout)')
+    parser.add_argument('--json', help='also write the results as JSON')
+    parser.add_argument('--baseline', help='CSV of an earlier run to check for regressions')
+    parser.add_argument('--tolerance', type=float, default=0.1, help='allowed ns/sample increase against --baseline')
+    args = parser.parse_args()
+
+    variants = args.variants.split(',')
+    if args.hls_include is None and any(v not in HOST_VARIANTS for v in variants):
+        parser.error('--hls-include or XILINX_HLS is needed for the csim variants')
+
+    rows = []
+    for length in [int(n) for n in args.lengths.split(',')]:
+        for variant in variants:
+            sys.stderr.write('%s, SIGNAL_LENGTH %d\n' % (variant, length))
+            rows += run(args, variant, length)
+
+    out = open(args.out, 'w', newline='') if args.out else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=FIELDS)
+    writer.writeheader()
+    writer.writerows(rows)
+    if args.out:
+        out.close()
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(rows, f, indent=1)
+
+    failed = False
+    for error in cross_check(rows):
+        sys.stderr.write('Location mismatch: %s\n' % error)
+        failed = True
+    if args.baseline:
+        for regression in compare_baseline(rows, args.baseline, args.tolerance):
+            sys.stderr.write('Regression: %s\n' % regression)
+            failed = True
+
+    sys.stderr.write('Benchmark %s\n' % ('failed' if failed else 'passed'))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,238 @@
+#ifndef IQ_CAPTURE_HPP
+#define IQ_CAPTURE_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary IQ capture (.iq), little-endian:
+//   64-byte header, iq_capture_header padded with zeros
+//   num_samples interleaved (re, im) words of word_format
+// IQ_WORD_Q2_16 words are the raw two's complement bits of ap_fixed<18,2>
+// sign-extended to int32_t, so the data feeds complex_stream exactly and the
+// host model in place, without parsing.
+namespace detector {
+
+const uint32_t IQ_CAPTURE_MAGIC = 0x51494450; // "PDIQ"
+const uint16_t IQ_CAPTURE_VERSION = 1;
+const uint32_t IQ_CAPTURE_HEADER_BYTES = 64;
+
+enum iq_word_format {
+    IQ_WORD_Q2_16 = 1 // int32_t, ap_fixed<18,2>: 16 fractional bits, 18 significant
+};
+
+struct iq_capture_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t word_format;
+    uint32_t header_bytes; // offset of the first sample
+    uint32_t frame_length; // samples per detector frame, 0 if unknown
+    uint64_t num_samples;  // complex samples
+    double sample_rate;    // Hz, 0 if unknown
+};
+
+// ap_fixed<18,2>(double) as a Q2_16 word: truncate, then wrap
+inline int32_t iqWord(double v) {
+    int64_t w = (int64_t)std::floor(std::ldexp(v, 16));
+    return (int32_t)((int64_t)((uint64_t)w << 46) >> 46);
+}
+
+inline double iqValue(int32_t w) {
+    return std::ldexp((double)w, -16);
+}
+
+// Read-only mapping of a capture file
+class iq_capture {
+public:
+    iq_capture() : base(NULL), bytes(0) {}
+    ~iq_capture() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.seekg(0, std::ios::end);
+        bytes = (size_t)file.tellg();
+        file.seekg(0, std::ios::beg);
+        buffer.resize(bytes);
+        file.read(buffer.data(), bytes);
+        base = buffer.data();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(iq_capture_header)) {
+            ::close(fd);
+            return false;
+        }
+        bytes = (size_t)st.st_size;
+        void* map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            bytes = 0;
+            return false;
+        }
+        madvise(map, bytes, MADV_SEQUENTIAL);
+        base = (const char*)map;
+#endif
+        if (!valid()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        std::vector<char>().swap(buffer);
+#else
+        if (base != NULL) {
+            munmap((void*)base, bytes);
+        }
+#endif
+        base = NULL;
+        bytes = 0;
+    }
+
+    bool isOpen() const { return base != NULL; }
+    const iq_capture_header& header() const { return *(const iq_capture_header*)base; }
+    size_t numSamples() const { return (size_t)header().num_samples; }
+    int frameLength() const { return (int)header().frame_length; }
+    double sampleRate() const { return header().sample_rate; }
+
+    // Interleaved re, im words; sample n is at data()[2 * n]
+    const int32_t* data() const { return (const int32_t*)(base + header().header_bytes); }
+
+    // Sample n as a complex HLS type, e.g. complex_fixed_point
+    template<typename COMPLEX_T>
+    COMPLEX_T sample(size_t n) const {
+        typedef typename COMPLEX_T::value_type value_t;
+        return COMPLEX_T(value_t(iqValue(data()[2 * n])), value_t(iqValue(data()[2 * n + 1])));
+    }
+
+    // Write samples [first, first + count) to an hls::stream
+    template<typename COMPLEX_T, typename STREAM_T>
+    void writeStream(STREAM_T& stream, size_t first, size_t count) const {
+        for (size_t n = first; n < first + count; n++) {
+            stream.write(sample<COMPLEX_T>(n));
+        }
+    }
+
+private:
+    bool valid() const {
+        if (bytes < sizeof(iq_capture_header)) {
+            return false;
+        }
+        const iq_capture_header& h = header();
+        return h.magic == IQ_CAPTURE_MAGIC && h.version == IQ_CAPTURE_VERSION && h.word_format == IQ_WORD_Q2_16
+            && h.header_bytes >= sizeof(iq_capture_header) && h.header_bytes <= bytes
+            && h.num_samples <= (bytes - h.header_bytes) / (2 * sizeof(int32_t));
+    }
+
+    const char* base;
+    size_t bytes;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+};
+
+// True if the file starts with the capture magic
+inline bool isIqCapture(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+    uint32_t magic = 0;
+    size_t n = std::fread(&magic, sizeof(magic), 1, file);
+    std::fclose(file);
+    return n == 1 && magic == IQ_CAPTURE_MAGIC;
+}
+
+// MATLAB text export ("re im" per line) to a capture file, quantised to
+// ap_fixed<18,2> the way the testbenches read it
+inline bool convertTextCapture(const std::string& text_path, const std::string& iq_path, uint32_t frame_length,
+                               double sample_rate) {
+    FILE* in = std::fopen(text_path.c_str(), "r");
+    if (in == NULL) {
+        return false;
+    }
+    FILE* out = std::fopen(iq_path.c_str(), "wb");
+    if (out == NULL) {
+        std::fclose(in);
+        return false;
+    }
+
+    char header_bytes[IQ_CAPTURE_HEADER_BYTES] = {0};
+    iq_capture_header h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = IQ_CAPTURE_MAGIC;
+    h.version = IQ_CAPTURE_VERSION;
+    h.word_format = IQ_WORD_Q2_16;
+    h.header_bytes = IQ_CAPTURE_HEADER_BYTES;
+    h.frame_length = frame_length;
+    h.sample_rate = sample_rate;
+    std::fwrite(header_bytes, 1, sizeof(header_bytes), out);
+
+    char line[256];
+    std::vector<int32_t> words;
+    while (std::fgets(line, sizeof(line), in) != NULL) {
+        char* end;
+        double real_part = std::strtod(line, &end);
+        if (end == line) {
+            continue;
+        }
+        const char* p = end;
+        double imag_part = std::strtod(p, &end);
+        if (end == p) {
+            continue;
+        }
+        words.push_back(iqWord(real_part));
+        words.push_back(iqWord(imag_part));
+        if (words.size() >= 1 << 16) {
+            std::fwrite(words.data(), sizeof(int32_t), words.size(), out);
+            h.num_samples += words.size() / 2;
+            words.clear();
+        }
+    }
+    std::fwrite(words.data(), sizeof(int32_t), words.size(), out);
+    h.num_samples += words.size() / 2;
+    std::fclose(in);
+
+    // Header last, once the sample count is known
+    std::fseek(out, 0, SEEK_SET);
+    std::fwrite(&h, sizeof(h), 1, out);
+    bool ok = std::ferror(out) == 0;
+    ok = std::fclose(out) == 0 && ok;
+    return ok;
+}
+
+// Map iq_path, converting text_path to it first if it does not exist yet
+inline bool openCapture(iq_capture& capture, const std::string& iq_path, const std::string& text_path,
+                        uint32_t frame_length) {
+    if (capture.open(iq_path)) {
+        return true;
+    }
+    return convertTextCapture(text_path, iq_path, frame_length, 0) && capture.open(iq_path);
+}
+
+} // namespace detector
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PULSE_DETECTOR_AXI_HPP
+#define PULSE_DETECTOR_AXI_HPP
+
+#include "pulseDetectorCore.hpp"
+#include <ap_int.h>
+
+// Memory-mapped front end: frames are read from DDR over an m_axi port in
+// bursts of BEAT_WIDTH-bit beats, and one result record per frame is written
+// back, so no AXI DMA IP or driver is needed between the PS and the detector.
+//
+// Frame buffer: the payload of a .iq capture (iqCapture.hpp) as is, i.e.
+// interleaved (re, im) IQ_WORD_Q2_16 words, little-endian. A 64-bit lane holds
+// one sample, re in the low word; a beat holds BEAT_WIDTH / 64 samples and a
+// frame CFG::frame / (BEAT_WIDTH / 64) beats, back to back.
+// Result record: 64 bits per frame, the peak as a Q2_16 word in the low 32
+// bits and the location in the high 32 bits.
+namespace detector {
+
+template<class CFG, int BEAT_WIDTH>
+struct axi_frames {
+    typedef ap_uint<BEAT_WIDTH> beat_t;
+    typedef ap_uint<64> record_t;
+    typedef hls::stream<beat_t> beat_stream;
+
+    static const int samples_per_beat = BEAT_WIDTH / 64;
+    static const int beats_per_frame = CFG::frame / samples_per_beat;
+    static_assert(BEAT_WIDTH % 64 == 0 && CFG::frame % samples_per_beat == 0,
+                  "a beat holds whole samples and a frame whole beats");
+
+    // Sequential reads at II=1, inferred as bursts; the FIFO behind them
+    // decouples the bus from the detector
+    static void readBeats(const beat_t* RxFrames, int num_frames, beat_stream& Beats) {
+        for (int i = 0; i < num_frames * beats_per_frame; i++) {
+#pragma HLS PIPELINE II=1
+            Beats.write(RxFrames[i]);
+        }
+    }
+
+    // One sample per cycle out of each beat
+    static void unpack(beat_stream& Beats, int num_frames, typename CFG::complex_stream& RxSignal) {
+        beat_t beat;
+        for (int i = 0; i < num_frames * CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+            int lane = i % samples_per_beat;
+            if (lane == 0) {
+                beat = Beats.read();
+            }
+            typename CFG::data_t re, im;
+            re.range(CFG::data_t::width - 1, 0) = beat.range(64 * lane + CFG::data_t::width - 1, 64 * lane);
+            im.range(CFG::data_t::width - 1, 0) = beat.range(64 * lane + 32 + CFG::data_t::width - 1, 64 * lane + 32);
+            RxSignal.write(typename CFG::complex_t(re, im));
+        }
+    }
+
+    static void writeRecords(typename CFG::detection_stream& Detections, int num_frames, record_t* Results) {
+        for (int f = 0; f < num_frames; f++) {
+#pragma HLS PIPELINE II=1
+            typename CFG::detection_t det = Detections.read();
+            ap_int<CFG::mag_t::width> peak_bits = det.peak.range(CFG::mag_t::width - 1, 0);
+            ap_int<32> peak_word = peak_bits;
+            record_t record;
+            record.range(31, 0) = peak_word;
+            record.range(63, 32) = det.location;
+            Results[f] = record;
+        }
+    }
+};
+
+} // namespace detector
+
+#endif
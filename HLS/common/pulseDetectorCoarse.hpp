@@ -0,0 +1,204 @@
+#ifndef PULSE_DETECTOR_COARSE_HPP
+#define PULSE_DETECTOR_COARSE_HPP
+
+#include "pulseDetectorCore.hpp"
+
+// Two-stage coarse-to-fine detection. A sign-bit correlator runs on every
+// sample in LUTs and marks the samples where the template may be present;
+// windows around them are forwarded to a time-shared full-precision
+// correlator that finds the peak. Both stages use the three-real template
+// (columns re+im, re-im, im), from which the complex tap is tr = c0 - c2,
+// ti = c2.
+namespace detector {
+
+// Inclusive range of frame samples forwarded to the fine stage; a record with
+// last set closes the frame
+struct coarse_window {
+    int start;
+    int end;
+    bool last;
+};
+
+typedef hls::stream<coarse_window> window_stream;
+
+// Coarse stage: the correlation of the sign bits of the samples with the sign
+// bits of the template, |re| + |im| of a sum of +/-1 terms, no multipliers.
+// A sample whose metric reaches the threshold opens a window of HALF_WIDTH
+// samples either side, and overlapping windows are merged. The frame is
+// stored for the fine stage. At most MAX_WINDOWS windows are sent per frame;
+// the last one is stretched to the end of the frame rather than dropping hits.
+template<class CFG, int HALF_WIDTH, int MAX_WINDOWS>
+struct coarse_sign {
+    // Sign bits of the template taps, true for negative
+    static void templateSigns(const typename CFG::coef_t taps[CFG::taps][3], bool tr[CFG::taps], bool ti[CFG::taps]) {
+#pragma HLS INLINE
+        for (int j = 0; j < CFG::taps; j++) {
+            tr[j] = taps[j][0] - taps[j][2] < 0;
+            ti[j] = taps[j][2] < 0;
+        }
+    }
+
+    // 0 .. 4 * taps; the real part is the sum of sgn(xr tr) - sgn(xi ti) and
+    // the imaginary part of sgn(xi tr) + sgn(xr ti)
+    static int metric(const bool sr[CFG::taps], const bool si[CFG::taps], const bool tr[CFG::taps], const bool ti[CFG::taps]) {
+#pragma HLS INLINE
+        int corr_real = 0;
+        int corr_imag = 0;
+        for (int j = 0; j < CFG::taps; j++) {
+            corr_real += (sr[j] != tr[j] ? -1 : 1) - (si[j] != ti[j] ? -1 : 1);
+            corr_imag += (si[j] != tr[j] ? -1 : 1) + (sr[j] != ti[j] ? -1 : 1);
+        }
+        return (corr_real < 0 ? -corr_real : corr_real) + (corr_imag < 0 ? -corr_imag : corr_imag);
+    }
+
+    static void coarseStage(typename CFG::complex_stream& RxSignal, int threshold, const typename CFG::coef_t taps[CFG::taps][3],
+                            typename CFG::complex_t frameBuf[CFG::frame], window_stream& Windows) {
+        bool tr[CFG::taps], ti[CFG::taps];
+        bool sr[CFG::taps], si[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=tr complete dim=1
+#pragma HLS ARRAY_PARTITION variable=ti complete dim=1
+#pragma HLS ARRAY_PARTITION variable=sr complete dim=1
+#pragma HLS ARRAY_PARTITION variable=si complete dim=1
+
+        templateSigns(taps, tr, ti);
+        for (int j = 0; j < CFG::taps; j++) {
+            sr[j] = false;
+            si[j] = false;
+        }
+
+        bool open = false;
+        coarse_window w;
+        int sent = 0;
+
+        for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+            typename CFG::complex_t x = RxSignal.read();
+            frameBuf[n] = x;
+            for (int j = CFG::taps - 1; j > 0; j--) {
+                sr[j] = sr[j - 1];
+                si[j] = si[j - 1];
+            }
+            sr[0] = x.real() < 0;
+            si[0] = x.imag() < 0;
+
+            if (metric(sr, si, tr, ti) >= threshold) {
+                int start = n - HALF_WIDTH < 0 ? 0 : n - HALF_WIDTH;
+                int end = n + HALF_WIDTH > CFG::frame - 1 ? CFG::frame - 1 : n + HALF_WIDTH;
+                if (open && (start <= w.end + 1 || sent == MAX_WINDOWS - 1)) {
+                    w.end = end;
+                } else {
+                    if (open) {
+                        Windows.write(w);
+                        sent++;
+                    }
+                    w.start = start;
+                    w.end = end;
+                    w.last = false;
+                    open = true;
+                }
+                if (sent == MAX_WINDOWS - 1) {
+                    w.end = CFG::frame - 1;
+                }
+            }
+        }
+
+        if (open) {
+            Windows.write(w);
+        }
+        coarse_window close;
+        close.start = 0;
+        close.end = -1;
+        close.last = true;
+        Windows.write(close);
+    }
+};
+
+// Fine stage: the three-real correlator of resource_opt3 over the forwarded
+// windows, time-shared FOLD ways. Each output takes FOLD cycles with
+// taps / FOLD multipliers per filter, 3 * taps / FOLD in all. Each window is
+// preceded by the taps - 1 samples before it, so every output is bit-exact
+// with the full correlator, and the peak search keeps its earliest-maximum
+// rule. Reports the outputs computed and the cycles spent.
+template<class CFG, int FOLD>
+void fineStage(const typename CFG::complex_t frameBuf[CFG::frame], window_stream& Windows, const typename CFG::coef_t taps[CFG::taps][3],
+               typename CFG::mag_t& peak, int& location, int& fine_samples, int& fine_cycles) {
+    static_assert(CFG::taps % FOLD == 0, "FOLD must divide the filter length");
+    const int M = CFG::taps / FOLD;
+
+    typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+#pragma HLS ARRAY_PARTITION variable=taps cyclic factor=M dim=1
+
+    typename CFG::mag_t current_peak = 0;
+    int current_location = 0;
+    int samples = 0;
+    int cycles = 0;
+
+    for (coarse_window w = Windows.read(); !w.last; w = Windows.read()) {
+        for (int j = 0; j < CFG::taps; j++) {
+#pragma HLS UNROLL
+            dataBuff[j] = 0;
+        }
+
+        int first = w.start - (CFG::taps - 1) < 0 ? 0 : w.start - (CFG::taps - 1);
+        for (int i = first; i < w.start; i++) {
+#pragma HLS PIPELINE II=1
+            shiftIn<CFG, CFG::taps>(dataBuff, frameBuf[i]);
+        }
+
+        // One phase per cycle: phase p takes taps p*M .. p*M+M-1 of every filter
+        typename CFG::acc_t conv_real = 0;
+        typename CFG::acc_t conv_imag = 0;
+        typename CFG::acc_t conv_plus = 0;
+        int n = w.start;
+        int phase = 0;
+        const int length = (w.end - w.start + 1) * FOLD;
+        for (int k = 0; k < length; k++) {
+#pragma HLS PIPELINE II=1
+            if (phase == 0) {
+                shiftIn<CFG, CFG::taps>(dataBuff, frameBuf[n]);
+            }
+
+            typename CFG::acc_t part_real = 0;
+            typename CFG::acc_t part_imag = 0;
+            typename CFG::acc_t part_plus = 0;
+            for (int m = 0; m < M; m++) {
+                int j = phase * M + m;
+                typename CFG::complex_t x = dataBuff[j];
+                part_real += x.real() * taps[j][0];
+                part_imag += x.imag() * taps[j][1];
+                part_plus += (x.real() + x.imag()) * taps[j][2];
+            }
+            // The partial sums are on the accumulator grid, so adding them
+            // truncates nothing further and the sum matches the direct form
+            conv_real = (phase == 0 ? typename CFG::acc_t(0) : conv_real) + part_real;
+            conv_imag = (phase == 0 ? typename CFG::acc_t(0) : conv_imag) + part_imag;
+            conv_plus = (phase == 0 ? typename CFG::acc_t(0) : conv_plus) + part_plus;
+
+            if (phase == FOLD - 1) {
+                typename CFG::mag_t magVal = three_real_mult<CFG>::combine(conv_real, conv_imag, conv_plus);
+                if (magVal > current_peak) {
+                    current_peak = magVal;
+                    current_location = n;
+                }
+                n++;
+                phase = 0;
+            } else {
+                phase++;
+            }
+        }
+
+        samples += w.end - w.start + 1;
+        cycles += w.start - first + length;
+    }
+    DETECTOR_PROBE_FRAME();
+
+    peak = current_peak;
+    location = current_location;
+    fine_samples = samples;
+    fine_cycles = cycles;
+}
+
+} // namespace detector
+
+#endif
@@ -0,0 +1,815 @@
+#ifndef PULSE_DETECTOR_CORE_HPP
+#define PULSE_DETECTOR_CORE_HPP
+
+#include <ap_fixed.h>
+#include <hls_stream.h>
+#include <complex>
+#include "pulseDetectorProbe.hpp"
+
+// Header-only detector core shared by the variants. A variant picks a sizing
+// and word-type configuration (detector::config) and a filter architecture
+// policy, then instantiates the stages below from its own top functions.
+//
+// Architecture policies:
+//   direct_complex   one complex multiply-accumulate per tap (origin, opt1, opt2)
+//   three_real_mult  three real filters, re+im / re-im / im taps (opt3)
+//   three_real_transposed, three_real_systolic
+//                    the same filters with registered accumulation (opt3,
+//                    MATCH_FILTER_FORM)
+//   fir_ip           three hls::FIR cores (opt4), see pulseDetectorFirIp.hpp
+//   csd_shift_add    three real filters as shift-add trees (opt7), see
+//                    pulseDetectorCsd.hpp
+// The accumulators and magnitudes carry csim-only overflow probes, see
+// pulseDetectorProbe.hpp.
+namespace detector {
+
+// Per-frame detection record emitted by the continuous (free-running) mode
+template<typename mag_t>
+struct detection_record {
+    mag_t peak;
+    int location;
+    int frame;
+};
+
+// (magnitude, location) pair reported by the top-K peak finder
+template<typename mag_t>
+struct peak_record {
+    mag_t peak;
+    int location;
+};
+
+// CFAR detection record; a record with last set (location -1) closes the frame
+template<typename mag_t>
+struct cfar_record {
+    mag_t peak;
+    int location;
+    bool last;
+};
+
+// Early detection record: the local maximum at location, confirmed at sample
+// timestamp of the same frame. A record with last set (location -1) closes
+// the frame.
+template<typename mag_t>
+struct early_record {
+    mag_t peak;
+    int location;
+    int timestamp;
+    bool last;
+};
+
+// Sizing and word types of one detector instance
+//   TAPS    matched filter length
+//   FRAME   samples per frame
+//   DATA_T  real and imaginary part of an input sample
+//   COEF_T  filter tap
+//   ACC_T   correlator accumulator
+//   MAG_T   magnitude squared at the filter output
+template<int TAPS, int FRAME, typename DATA_T, typename COEF_T = DATA_T, typename ACC_T = DATA_T, typename MAG_T = ACC_T>
+struct config {
+    static const int taps = TAPS;
+    static const int frame = FRAME;
+
+    typedef DATA_T data_t;
+    typedef COEF_T coef_t;
+    typedef ACC_T acc_t;
+    typedef MAG_T mag_t;
+    typedef std::complex<DATA_T> complex_t;
+    typedef std::complex<COEF_T> complex_coef_t;
+
+    typedef hls::stream<complex_t> complex_stream;
+    typedef hls::stream<MAG_T> real_stream;
+
+    typedef detection_record<MAG_T> detection_t;
+    typedef hls::stream<detection_t> detection_stream;
+    typedef peak_record<MAG_T> peak_t;
+    typedef hls::stream<peak_t> peak_stream;
+    typedef cfar_record<MAG_T> cfar_detection_t;
+    typedef hls::stream<cfar_detection_t> cfar_stream;
+    typedef early_record<MAG_T> early_detection_t;
+    typedef hls::stream<early_detection_t> early_stream;
+};
+
+// Shift one sample into the delay line
+template<class CFG, int LENGTH>
+void shiftIn(typename CFG::complex_t dataBuff[LENGTH], typename CFG::complex_t rx_sample) {
+#pragma HLS INLINE
+    for (int j = LENGTH - 1; j > 0; j--) {
+        dataBuff[j] = dataBuff[j - 1];
+    }
+    dataBuff[0] = rx_sample;
+}
+
+// One complex multiply-accumulate per tap
+template<class CFG>
+struct direct_complex {
+    typedef typename CFG::complex_coef_t tap_t;
+
+    static void convert(const typename CFG::complex_t& c, tap_t& tap) {
+#pragma HLS INLINE
+        tap = tap_t(c.real(), c.imag());
+    }
+
+    // Correlator magnitude squared. Tap j multiplies dataBuff[j * STRIDE], so a
+    // delay line of z^-STRIDE elements serves STRIDE interleaved channels. T is
+    // tap_t or const tap_t, for loadable banks and ROM templates alike.
+    template<int STRIDE, typename T>
+    static typename CFG::mag_t correlate(const typename CFG::complex_t dataBuff[], T taps[CFG::taps]) {
+#pragma HLS INLINE
+        typename CFG::acc_t sum_real = 0;
+        typename CFG::acc_t sum_imag = 0;
+        DETECTOR_PROBE_SUM(sum_real);
+        DETECTOR_PROBE_SUM(sum_imag);
+
+        for (int j = 0; j < CFG::taps; j++) {
+            typename CFG::complex_t x = dataBuff[j * STRIDE];
+            typename CFG::acc_t prod_real = x.real() * taps[j].real() - x.imag() * taps[j].imag();
+            typename CFG::acc_t prod_imag = x.real() * taps[j].imag() + x.imag() * taps[j].real();
+            DETECTOR_PROBE_VALUE(prod_real, typename CFG::acc_t, double(x.real() * taps[j].real() - x.imag() * taps[j].imag()));
+            DETECTOR_PROBE_VALUE(prod_imag, typename CFG::acc_t, double(x.real() * taps[j].imag() + x.imag() * taps[j].real()));
+            sum_real += prod_real;
+            sum_imag += prod_imag;
+            DETECTOR_PROBE_ADD(sum_real, typename CFG::acc_t, prod_real);
+            DETECTOR_PROBE_ADD(sum_imag, typename CFG::acc_t, prod_imag);
+        }
+        DETECTOR_PROBE_END(sum_real, typename CFG::acc_t);
+        DETECTOR_PROBE_END(sum_imag, typename CFG::acc_t);
+        DETECTOR_PROBE_VALUE(sum_mag_squared, typename CFG::mag_t, double(sum_real * sum_real + sum_imag * sum_imag));
+
+        return sum_real * sum_real + sum_imag * sum_imag;
+    }
+};
+
+// Three real filters over re, im and re+im; per tap the columns hold
+// re+im, re-im and im of the template, so only three multipliers are needed
+template<class CFG>
+struct three_real_mult {
+    typedef typename CFG::coef_t tap_t[3];
+
+    // Convert one complex template tap to the three-real form
+    static void convert(const typename CFG::complex_t& c, tap_t tap) {
+#pragma HLS INLINE
+        tap[0] = c.real() + c.imag();
+        tap[1] = c.real() - c.imag();
+        tap[2] = c.imag();
+    }
+
+    template<int STRIDE, typename T>
+    static typename CFG::mag_t correlate(const typename CFG::complex_t dataBuff[], T taps[CFG::taps][3]) {
+#pragma HLS INLINE
+        typename CFG::acc_t conv_real = 0;
+        typename CFG::acc_t conv_imag = 0;
+        typename CFG::acc_t conv_plus = 0;
+        DETECTOR_PROBE_SUM(conv_real);
+        DETECTOR_PROBE_SUM(conv_imag);
+        DETECTOR_PROBE_SUM(conv_plus);
+
+        for (int j = 0; j < CFG::taps; j++) {
+            typename CFG::complex_t x = dataBuff[j * STRIDE];
+            conv_real += x.real() * taps[j][0];
+            conv_imag += x.imag() * taps[j][1];
+            conv_plus += (x.real() + x.imag()) * taps[j][2];
+            DETECTOR_PROBE_ADD(conv_real, typename CFG::acc_t, x.real() * taps[j][0]);
+            DETECTOR_PROBE_ADD(conv_imag, typename CFG::acc_t, x.imag() * taps[j][1]);
+            DETECTOR_PROBE_ADD(conv_plus, typename CFG::acc_t, (x.real() + x.imag()) * taps[j][2]);
+        }
+        DETECTOR_PROBE_END(conv_real, typename CFG::acc_t);
+        DETECTOR_PROBE_END(conv_imag, typename CFG::acc_t);
+        DETECTOR_PROBE_END(conv_plus, typename CFG::acc_t);
+
+        return combine(conv_real, conv_imag, conv_plus);
+    }
+
+    // Magnitude squared from the three filter outputs
+    static typename CFG::mag_t combine(typename CFG::acc_t conv_real, typename CFG::acc_t conv_imag, typename CFG::acc_t conv_plus) {
+#pragma HLS INLINE
+        typename CFG::acc_t real = conv_real - conv_plus;
+        typename CFG::acc_t imag = conv_imag + conv_plus;
+        DETECTOR_PROBE_VALUE(real, typename CFG::acc_t, double(conv_real) - double(conv_plus));
+        DETECTOR_PROBE_VALUE(imag, typename CFG::acc_t, double(conv_imag) + double(conv_plus));
+        DETECTOR_PROBE_VALUE(mag, typename CFG::mag_t, double(real * real + imag * imag));
+
+        return real * real + imag * imag;
+    }
+};
+
+// Three-real filters in transposed form: each tap multiplies the current
+// sample and adds it to a register holding the partial sum of the later taps,
+// so there is one adder between registers instead of a TAPS-input sum per
+// output. No extra latency, but the sample fans out to every multiplier.
+// Sums wrap, so the result is bit-exact with three_real_mult.
+template<class CFG>
+struct three_real_transposed : three_real_mult<CFG> {
+    typedef typename three_real_mult<CFG>::tap_t tap_t;
+    static const int latency = 0;
+
+    // One sample through the filters; z[k][j] is the partial sum of taps
+    // j .. taps-1 of filter k (z[k][0] is unused)
+    template<typename T>
+    static typename CFG::mag_t step(const typename CFG::complex_t& x, T taps[CFG::taps][3], typename CFG::acc_t z[3][CFG::taps]) {
+#pragma HLS INLINE
+        typename CFG::acc_t conv_real = x.real() * taps[0][0] + z[0][1 % CFG::taps];
+        typename CFG::acc_t conv_imag = x.imag() * taps[0][1] + z[1][1 % CFG::taps];
+        typename CFG::acc_t conv_plus = (x.real() + x.imag()) * taps[0][2] + z[2][1 % CFG::taps];
+
+        // Ascending, so z[k][j + 1] still holds the previous sample's sum
+        for (int j = 1; j < CFG::taps; j++) {
+            bool last = j == CFG::taps - 1;
+            int next = last ? j : j + 1;
+            z[0][j] = x.real() * taps[j][0] + (last ? typename CFG::acc_t(0) : z[0][next]);
+            z[1][j] = x.imag() * taps[j][1] + (last ? typename CFG::acc_t(0) : z[1][next]);
+            z[2][j] = (x.real() + x.imag()) * taps[j][2] + (last ? typename CFG::acc_t(0) : z[2][next]);
+        }
+
+        return three_real_mult<CFG>::combine(conv_real, conv_imag, conv_plus);
+    }
+
+    // Single frame: the partial sums start cleared
+    static void matchFilter(typename CFG::complex_stream& RxSignal, const tap_t taps[CFG::taps], typename CFG::real_stream& FilterOut) {
+        typename CFG::acc_t z[3][CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=z complete dim=0
+
+        for (int k = 0; k < 3; k++) {
+            for (int j = 0; j < CFG::taps; j++) {
+                z[k][j] = 0;
+            }
+        }
+
+        for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+            FilterOut.write(step(RxSignal.read(), taps, z));
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+
+    // Continuous mode: the partial sums carry the previous frame's tail
+    static void matchFilterStream(typename CFG::complex_stream& RxSignal, const tap_t taps[CFG::taps], typename CFG::real_stream& FilterOut) {
+        static typename CFG::acc_t z[3][CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=z complete dim=0
+
+        for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1 rewind
+            FilterOut.write(step(RxSignal.read(), taps, z));
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+};
+
+// Three-real filters as a systolic array, the structure of a DSP48 cascade:
+// the sample moves through two registers per tap and the partial sum through
+// one, so every stage is a pre-add (re+im), a multiply and an add into the
+// next stage, with no fan-out and no long carry chain. Output n leaves
+// latency = taps samples after sample n.
+// With acc_t as wide as data_t each stage truncates like three_real_mult, so
+// the result is bit-exact and the narrow adds stay in the fabric; a wide ACC_T
+// in the config lets them merge into the DSP48 post-adders (PCIN/PCOUT).
+template<class CFG>
+struct three_real_systolic : three_real_mult<CFG> {
+    typedef typename three_real_mult<CFG>::tap_t tap_t;
+    static const int latency = CFG::taps;
+
+    // One clock of the array. xd[m] holds the sample m + 1 clocks old and s[k][j]
+    // the sum of taps 0 .. j of filter k; returns the output for the sample
+    // that entered latency clocks ago.
+    template<typename T>
+    static typename CFG::mag_t step(const typename CFG::complex_t& x, T taps[CFG::taps][3], typename CFG::complex_t xd[2 * CFG::taps], typename CFG::acc_t s[3][CFG::taps]) {
+#pragma HLS INLINE
+        // Descending, so stage j adds to stage j-1's previous sum
+        for (int j = CFG::taps - 1; j >= 0; j--) {
+            typename CFG::complex_t xj = xd[2 * j];
+            int prev = j > 0 ? j - 1 : 0;
+            s[0][j] = (j > 0 ? s[0][prev] : typename CFG::acc_t(0)) + xj.real() * taps[j][0];
+            s[1][j] = (j > 0 ? s[1][prev] : typename CFG::acc_t(0)) + xj.imag() * taps[j][1];
+            s[2][j] = (j > 0 ? s[2][prev] : typename CFG::acc_t(0)) + (xj.real() + xj.imag()) * taps[j][2];
+        }
+        shiftIn<CFG, 2 * CFG::taps>(xd, x);
+
+        return three_real_mult<CFG>::combine(s[0][CFG::taps - 1], s[1][CFG::taps - 1], s[2][CFG::taps - 1]);
+    }
+
+    // Single frame: zeros are fed for latency clocks after the last sample to
+    // flush the array, and the first latency outputs are dropped
+    static void matchFilter(typename CFG::complex_stream& RxSignal, const tap_t taps[CFG::taps], typename CFG::real_stream& FilterOut) {
+        typename CFG::complex_t xd[2 * CFG::taps];
+        typename CFG::acc_t s[3][CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=xd complete dim=1
+#pragma HLS ARRAY_PARTITION variable=s complete dim=0
+
+        for (int j = 0; j < 2 * CFG::taps; j++) {
+            xd[j] = 0;
+        }
+        for (int k = 0; k < 3; k++) {
+            for (int j = 0; j < CFG::taps; j++) {
+                s[k][j] = 0;
+            }
+        }
+
+        for (int i = 0; i < CFG::frame + latency; i++) {
+#pragma HLS PIPELINE II=1
+            typename CFG::complex_t x(0, 0);
+            if (i < CFG::frame) {
+                x = RxSignal.read();
+            }
+            typename CFG::mag_t magVal = step(x, taps, xd, s);
+            if (i >= latency) {
+                FilterOut.write(magVal);
+            }
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+};
+
+// Read a runtime template of CFG::taps complex taps
+template<class CFG>
+void loadTaps(typename CFG::complex_stream& CorrFilter, typename CFG::complex_coef_t taps[CFG::taps]) {
+    for (int i = 0; i < CFG::taps; i++) {
+#pragma HLS PIPELINE II=1
+        taps[i] = CorrFilter.read();
+    }
+}
+
+// Single frame: the delay line starts cleared
+template<class CFG, class ARCH>
+void matchFilter(typename CFG::complex_stream& RxSignal, const typename ARCH::tap_t taps[CFG::taps], typename CFG::real_stream& FilterOut) {
+    typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < CFG::taps; i++) {
+        dataBuff[i] = 0;
+    }
+
+    for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+        shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+        FilterOut.write(ARCH::template correlate<1>(dataBuff, taps));
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+// Single frame with the runtime template read first, as the origin baseline
+// is written: no pipeline pragmas, so the tool's automatic loop pipelining
+// picks the schedule and origin keeps the QoR of its checked-in logs
+template<class CFG, class ARCH>
+void matchFilterUnpipelined(typename CFG::complex_stream& RxSignal, typename CFG::complex_stream& CorrFilter, typename CFG::real_stream& FilterOut) {
+    typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < CFG::taps; i++) {
+        dataBuff[i] = 0;
+    }
+
+    typename ARCH::tap_t taps[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=taps complete dim=1
+    for (int i = 0; i < CFG::taps; i++) {
+        ARCH::convert(CorrFilter.read(), taps[i]);
+    }
+
+    for (int i = 0; i < CFG::frame; i++) {
+        shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+        FilterOut.write(ARCH::template correlate<1>(dataBuff, taps));
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+// Continuous mode: the delay line is never cleared, so the first taps-1
+// outputs of a frame are computed from the tail of the previous frame
+template<class CFG, class ARCH>
+void matchFilterStream(typename CFG::complex_stream& RxSignal, const typename ARCH::tap_t taps[CFG::taps], typename CFG::real_stream& FilterOut) {
+    static typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1 rewind
+        shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+        FilterOut.write(ARCH::template correlate<1>(dataBuff, taps));
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+// Reload mode: taps persist across calls in two banks, bank 0 initialised by
+// the variant with its compiled-in template. A new set written to CoeffIn is
+// converted and loaded into the inactive bank one tap per cycle while samples
+// keep streaming, then swapped in at the next frame start.
+template<class CFG, class ARCH>
+void matchFilterReload(typename CFG::complex_stream& RxSignal, typename CFG::complex_stream& CoeffIn, typename ARCH::tap_t tapBank[2][CFG::taps], typename CFG::real_stream& FilterOut) {
+#pragma HLS ARRAY_PARTITION variable=tapBank complete dim=0
+    static bool active = 0;
+    static bool pending = false;
+    static int load_index = 0;
+
+    typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < CFG::taps; i++) {
+        dataBuff[i] = 0;
+    }
+
+    // Atomic swap at the frame boundary
+    if (pending) {
+        active = !active;
+        pending = false;
+    }
+
+    for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::complex_t tap;
+        // A complete set waiting for the swap blocks further loads, so the
+        // host's next set stays queued in CoeffIn
+        if (!pending && CoeffIn.read_nb(tap)) {
+            ARCH::convert(tap, tapBank[!active][load_index]);
+            if (load_index == CFG::taps - 1) {
+                load_index = 0;
+                pending = true;
+            } else {
+                load_index++;
+            }
+        }
+
+        shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+        FilterOut.write(ARCH::template correlate<1>(dataBuff, tapBank[active]));
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+// ceil(log2(N)) for sizing sums of N terms
+template<int N>
+struct log2_ceil {
+    static const int value = 1 + log2_ceil<(N + 1) / 2>::value;
+};
+
+template<>
+struct log2_ceil<1> {
+    static const int value = 0;
+};
+
+// Energy of the last taps samples, sum of re^2 + im^2. The type holds every
+// square and their sum exactly, so the running update never drifts.
+template<class CFG>
+struct energy_gate {
+    typedef ap_fixed<2 * CFG::data_t::width + 2 + log2_ceil<CFG::taps>::value, 2 * CFG::data_t::iwidth + 2 + log2_ceil<CFG::taps>::value> energy_t;
+
+    static energy_t power(const typename CFG::complex_t& x) {
+#pragma HLS INLINE
+        return energy_t(x.real() * x.real()) + energy_t(x.imag() * x.imag());
+    }
+};
+
+#ifndef __SYNTHESIS__
+// C simulation only: cycles seen and gated by matchFilterGated
+struct gate_counter {
+    long cycles;
+    long gated;
+
+    static gate_counter& instance() {
+        static gate_counter c = {0, 0};
+        return c;
+    }
+
+    double gatedFraction() const { return cycles > 0 ? (double)gated / cycles : 0; }
+};
+#endif
+
+// Energy-gated filter: while the energy of the samples in the delay line is
+// below threshold, the multipliers see zeros (operand isolation), so they do
+// not toggle, and the output is 0, no detection. The delay line keeps
+// shifting, so the first sample of a pulse is never lost. The window is the
+// filter span, so by Cauchy-Schwarz a gated output is below threshold times
+// the template energy: outputs above that are always computed, bit-exact.
+template<class CFG, class ARCH>
+void matchFilterGated(typename CFG::complex_stream& RxSignal, const typename ARCH::tap_t taps[CFG::taps],
+                      typename energy_gate<CFG>::energy_t threshold, typename CFG::real_stream& FilterOut) {
+    typename CFG::complex_t dataBuff[CFG::taps];
+    typename CFG::complex_t isolated[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+#pragma HLS ARRAY_PARTITION variable=isolated complete dim=1
+    typename energy_gate<CFG>::energy_t energy = 0;
+
+    for (int i = 0; i < CFG::taps; i++) {
+        dataBuff[i] = 0;
+    }
+
+    for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::complex_t x = RxSignal.read();
+        energy += energy_gate<CFG>::power(x) - energy_gate<CFG>::power(dataBuff[CFG::taps - 1]);
+        shiftIn<CFG, CFG::taps>(dataBuff, x);
+
+        bool gated = energy < threshold;
+        for (int j = 0; j < CFG::taps; j++) {
+            isolated[j] = gated ? typename CFG::complex_t(0, 0) : dataBuff[j];
+        }
+        FilterOut.write(ARCH::template correlate<1>(isolated, taps));
+
+#ifndef __SYNTHESIS__
+        gate_counter::instance().cycles++;
+        gate_counter::instance().gated += gated;
+#endif
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+// Filter and peak search merged into one loop, no stream between them
+template<class CFG, class ARCH>
+void filterPeak(typename CFG::complex_stream& RxSignal, const typename ARCH::tap_t taps[CFG::taps], typename CFG::mag_t& peak, int& location) {
+    typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < CFG::taps; i++) {
+        dataBuff[i] = 0;
+    }
+
+    typename CFG::mag_t current_peak = 0;
+    int current_location = 0;
+
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+        shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+        typename CFG::mag_t magVal = ARCH::template correlate<1>(dataBuff, taps);
+
+        // peak finding logic
+        if (magVal > current_peak) {
+            current_peak = magVal;
+            current_location = n;
+        }
+    }
+    DETECTOR_PROBE_FRAME();
+
+    peak = current_peak;
+    location = current_location;
+}
+
+template<class CFG>
+void peakFinder(typename CFG::real_stream& FilterOut, typename CFG::mag_t& peak, int& location) {
+    typename CFG::mag_t current_peak = 0;
+    int current_location = 0;
+
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::mag_t magVal = FilterOut.read();
+
+        if (magVal > current_peak) {
+            current_peak = magVal;
+            current_location = n;
+        }
+    }
+
+    peak = current_peak;
+    location = current_location;
+}
+
+// peakFinder that also reports every local maximum above threshold as soon as
+// it is confirmed, instead of only the global peak at the end of the frame.
+// A rising sample at or above threshold opens a candidate, and a larger sample
+// replaces it. Once HOLDOFF samples have passed without a larger one, the
+// candidate is written to Early, HOLDOFF samples after its location, so the
+// report latency does not depend on the frame length. A candidate still open
+// at the end of the frame is written there, then the closing record. peak and
+// location are the end-of-frame summary of peakFinder.
+template<class CFG, int HOLDOFF>
+void peakFinderEarly(typename CFG::real_stream& FilterOut, typename CFG::mag_t threshold, typename CFG::early_stream& Early,
+                     typename CFG::mag_t& peak, int& location) {
+    static_assert(HOLDOFF >= 1, "a candidate needs at least one later sample to be confirmed");
+    typename CFG::mag_t current_peak = 0;
+    int current_location = 0;
+    typename CFG::mag_t previous = 0;
+    bool open = false;
+    typename CFG::mag_t candidate_peak = 0;
+    int candidate_location = 0;
+
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::mag_t magVal = FilterOut.read();
+
+        if (magVal > current_peak) {
+            current_peak = magVal;
+            current_location = n;
+        }
+
+        if (open && magVal > candidate_peak) {
+            candidate_peak = magVal;
+            candidate_location = n;
+        } else {
+            if (open && n - candidate_location == HOLDOFF) {
+                typename CFG::early_detection_t det;
+                det.peak = candidate_peak;
+                det.location = candidate_location;
+                det.timestamp = n;
+                det.last = false;
+                Early.write(det);
+                open = false;
+            }
+            if (!open && magVal >= threshold && magVal > previous) {
+                candidate_peak = magVal;
+                candidate_location = n;
+                open = true;
+            }
+        }
+        previous = magVal;
+    }
+
+    if (open) {
+        typename CFG::early_detection_t det;
+        det.peak = candidate_peak;
+        det.location = candidate_location;
+        det.timestamp = CFG::frame - 1;
+        det.last = false;
+        Early.write(det);
+    }
+    typename CFG::early_detection_t eof;
+    eof.peak = 0;
+    eof.location = -1;
+    eof.timestamp = CFG::frame - 1;
+    eof.last = true;
+    Early.write(eof);
+
+    peak = current_peak;
+    location = current_location;
+}
+
+template<class CFG>
+void peakFinderStream(typename CFG::real_stream& FilterOut, typename CFG::detection_stream& Detections) {
+    static typename CFG::mag_t current_peak = 0;
+    static int current_location = 0;
+    static int frame = 0;
+
+    // The record is written from inside the loop so that the next frame can
+    // start on the following cycle without an epilogue
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1 rewind
+        typename CFG::mag_t magVal = FilterOut.read();
+
+        if (magVal > current_peak) {
+            current_peak = magVal;
+            current_location = n;
+        }
+
+        if (n == CFG::frame - 1) {
+            typename CFG::detection_t det;
+            det.peak = current_peak;
+            det.location = current_location;
+            det.frame = frame;
+            Detections.write(det);
+
+            current_peak = 0;
+            current_location = 0;
+            frame++;
+        }
+    }
+}
+
+// Insert a candidate into the descending-sorted slot list. All K comparisons
+// are made in parallel against the old contents, so the update fits in one cycle.
+template<class CFG, int K>
+void insertPeak(typename CFG::mag_t slot_peak[K], int slot_location[K], typename CFG::mag_t cand_peak, int cand_location) {
+#pragma HLS INLINE
+    bool greater[K];
+#pragma HLS ARRAY_PARTITION variable=greater complete dim=1
+    for (int k = 0; k < K; k++) {
+        greater[k] = cand_peak > slot_peak[k];
+    }
+
+    for (int k = K - 1; k >= 0; k--) {
+        if (greater[k]) {
+            if (k > 0 && greater[k - 1]) {
+                slot_peak[k] = slot_peak[k - 1];
+                slot_location[k] = slot_location[k - 1];
+            } else {
+                slot_peak[k] = cand_peak;
+                slot_location[k] = cand_location;
+            }
+        }
+    }
+}
+
+// Top-K mode: K peaks per frame, strongest first, at least MIN_SEP samples apart
+template<class CFG, int K, int MIN_SEP>
+void peakFinderTopK(typename CFG::real_stream& FilterOut, typename CFG::peak_stream& Peaks) {
+    typename CFG::mag_t slot_peak[K];
+    int slot_location[K];
+#pragma HLS ARRAY_PARTITION variable=slot_peak complete dim=1
+#pragma HLS ARRAY_PARTITION variable=slot_location complete dim=1
+
+    // Unused slots keep magnitude 0 and location -1
+    for (int k = 0; k < K; k++) {
+#pragma HLS UNROLL
+        slot_peak[k] = 0;
+        slot_location[k] = -1;
+    }
+
+    // Local maximum of the current run. Only a rising sample opens a
+    // candidate and a larger one replaces it; it is committed to the slot list
+    // once MIN_SEP samples have passed without a larger value. The decaying
+    // skirt of a peak never rises, so one peak occupies at most one slot.
+    typename CFG::mag_t previous = 0;
+    bool open = false;
+    typename CFG::mag_t cand_peak = 0;
+    int cand_location = 0;
+
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::mag_t magVal = FilterOut.read();
+
+        if (open && magVal > cand_peak) {
+            cand_peak = magVal;
+            cand_location = n;
+        } else {
+            if (open && n - cand_location >= MIN_SEP) {
+                insertPeak<CFG, K>(slot_peak, slot_location, cand_peak, cand_location);
+                open = false;
+            }
+            if (!open && magVal > previous) {
+                cand_peak = magVal;
+                cand_location = n;
+                open = true;
+            }
+        }
+        previous = magVal;
+    }
+    if (open) {
+        insertPeak<CFG, K>(slot_peak, slot_location, cand_peak, cand_location);
+    }
+
+    for (int k = 0; k < K; k++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::peak_t p;
+        p.peak = slot_peak[k];
+        p.location = slot_location[k];
+        Peaks.write(p);
+    }
+}
+
+// Copy a stream to two consumers of the same DATAFLOW region
+template<typename data_t, int LENGTH>
+void duplicate(hls::stream<data_t> &in, hls::stream<data_t> &out1, hls::stream<data_t> &out2) {
+
+    for(unsigned i = 0; i < LENGTH; i++) {
+#pragma HLS PIPELINE II=1 rewind=true
+        data_t val = in.read();
+        out1.write(val);
+        out2.write(val);
+    }
+}
+
+// CA-CFAR with GUARD guard and TRAIN training cells on each side of the cell
+// under test and threshold SCALE_NUM/SCALE_DEN times the mean training power.
+// SUM_T holds the running sums of TRAIN cells exactly.
+template<class CFG, int GUARD, int TRAIN, int SCALE_NUM, int SCALE_DEN, typename SUM_T>
+void cfarDetector(typename CFG::real_stream& FilterOut, typename CFG::cfar_stream& Detections) {
+    // Window layout, newest sample first:
+    //   [0, TRAIN)                      lagging training cells
+    //   [TRAIN, TRAIN+GUARD)            lagging guard cells
+    //   CUT = TRAIN+GUARD               cell under test
+    //   (CUT, CUT+GUARD]                leading guard cells
+    //   (CUT+GUARD, WINDOW)             leading training cells
+    const int WINDOW = 2 * (TRAIN + GUARD) + 1;
+    const int CUT = TRAIN + GUARD;
+
+    typename CFG::mag_t window[WINDOW];
+#pragma HLS ARRAY_PARTITION variable=window complete dim=1
+    for (int k = 0; k < WINDOW; k++) {
+#pragma HLS UNROLL
+        window[k] = 0;
+    }
+
+    // Running sums of the two training regions, updated with one add and one
+    // subtract per sample instead of re-summing the window
+    SUM_T lag_sum = 0;
+    SUM_T lead_sum = 0;
+
+    for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+        typename CFG::mag_t magVal = FilterOut.read();
+
+        lag_sum += magVal - window[TRAIN - 1];
+        lead_sum += window[CUT + GUARD] - window[WINDOW - 1];
+
+        for (int k = WINDOW - 1; k > 0; k--) {
+            window[k] = window[k - 1];
+        }
+        window[0] = magVal;
+
+        // Only cells with a full training window on both sides are tested.
+        // The comparison is cross-multiplied so no divider is needed:
+        //   CUT > SCALE_NUM/SCALE_DEN * (lag_sum + lead_sum) / (2*TRAIN)
+        typename CFG::mag_t cut = window[CUT];
+        bool full = n >= WINDOW - 1;
+        bool above = cut * (2 * TRAIN * SCALE_DEN) > (lag_sum + lead_sum) * SCALE_NUM;
+        bool local_max = cut > window[CUT + 1] && cut >= window[CUT - 1];
+        if (full && above && local_max) {
+            typename CFG::cfar_detection_t det;
+            det.peak = cut;
+            det.location = n - CUT;
+            det.last = false;
+            Detections.write(det);
+        }
+    }
+
+    typename CFG::cfar_detection_t eof;
+    eof.peak = 0;
+    eof.location = -1;
+    eof.last = true;
+    Detections.write(eof);
+}
+
+} // namespace detector
+
+#endif
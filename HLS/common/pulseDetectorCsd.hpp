@@ -0,0 +1,310 @@
+#ifndef PULSE_DETECTOR_CSD_HPP
+#define PULSE_DETECTOR_CSD_HPP
+
+#include "pulseDetectorCore.hpp"
+#include "pulseDetectorTaps.hpp"
+
+// Multiplierless three-real correlator for a template fixed at compile time.
+// Every tap is quantised to CFG::coef_t and recoded into canonical signed
+// digit (CSD) form by constexpr code, so x * tap becomes a handful of shifted
+// adds of x. Digit pairs (i, i + d) that recur across the taps of one filter
+// are built once per sample as x +/- (x << d) and shared by every tap that
+// uses them. The filters are in transposed form: all products are taken from
+// the current sample and summed into a chain of partial-sum registers, so the
+// adder trees stay a few levels deep at any filter length.
+//
+// The products are exact and each one is truncated into the accumulator the
+// way three_real_mult does it, so the output is bit-exact with resource_opt3.
+namespace detector {
+namespace csd {
+
+// Term of a CSD product: sign * (source << shift), where source 0 is the
+// input scaled by the tap LSB and source 1 + p is shared pair p
+struct term {
+    int source;
+    int shift;
+    int sign;
+};
+
+// Digit i (weight 2^i) of the CSD form of n: -1, 0 or 1, and no two adjacent
+// digits are nonzero
+constexpr int digit(long long n, int i) {
+    for (int k = 0; k < i; k++) {
+        if (n & 1) {
+            n -= 2 - (n & 3);
+        }
+        n /= 2;
+    }
+    return (n & 1) ? (int)(2 - (n & 3)) : 0;
+}
+
+// Number of non-overlapping digit pairs (i, i + DISTANCE) with
+// digit[i + DISTANCE] == SIGN * digit[i], scanned from the LSB. With a term
+// list, the pairs are also cleared and appended as terms of SOURCE.
+template<int TAPS, int DIGITS>
+constexpr int matchPairs(int (&digits)[TAPS][DIGITS], int distance, int sign, int source, term (*terms)[DIGITS], int* num_terms) {
+    int count = 0;
+    for (int j = 0; j < TAPS; j++) {
+        bool used[DIGITS] = {};
+        for (int i = 0; i + distance < DIGITS; i++) {
+            int lo = digits[j][i];
+            int hi = digits[j][i + distance];
+            if (lo != 0 && hi == sign * lo && !used[i] && !used[i + distance]) {
+                used[i] = true;
+                used[i + distance] = true;
+                count++;
+                if (terms != nullptr) {
+                    digits[j][i] = 0;
+                    digits[j][i + distance] = 0;
+                    term& t = terms[j][num_terms[j]++];
+                    t.source = source;
+                    t.shift = i;
+                    t.sign = lo;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Shift-add plan of the three filters of the three-real form. TAPS::value(j, k)
+// returns column k of tap j (re+im, re-im, im) as a double; at most PAIRS digit
+// pairs are shared per filter, and only pairs that occur at least twice.
+template<class CFG, class TAPS, int PAIRS>
+struct plan {
+    static const int width = CFG::coef_t::width;
+    static const int frac = CFG::coef_t::width - CFG::coef_t::iwidth;
+    static const int digits = width + 1;
+
+    struct value_t {
+        int num_pairs[3];
+        int pair_distance[3][PAIRS];
+        int pair_sign[3][PAIRS];
+        int num_terms[3][CFG::taps];
+        term terms[3][CFG::taps][digits];
+        int adders[3];          // adds of the shared pairs and the product trees
+        int adders_unshared[3]; // the same with every nonzero digit a term of its own
+    };
+
+    static constexpr value_t build() {
+        value_t v{};
+        for (int k = 0; k < 3; k++) {
+            int d[CFG::taps][digits] = {};
+            for (int j = 0; j < CFG::taps; j++) {
+                long long n = coeff::quantise(TAPS::value(j, k), width, frac);
+                int nonzero = 0;
+                for (int i = 0; i < digits; i++) {
+                    d[j][i] = digit(n, i);
+                    nonzero += d[j][i] != 0;
+                }
+                if (nonzero > 1) {
+                    v.adders_unshared[k] += nonzero - 1;
+                }
+            }
+
+            // Greedy: share the most frequent remaining pair, then recount
+            for (int p = 0; p < PAIRS; p++) {
+                int best = 1;
+                int best_distance = 0;
+                int best_sign = 0;
+                for (int distance = 2; distance < digits; distance++) {
+                    for (int sign = -1; sign <= 1; sign += 2) {
+                        int count = matchPairs<CFG::taps, digits>(d, distance, sign, 0, nullptr, nullptr);
+                        if (count > best) {
+                            best = count;
+                            best_distance = distance;
+                            best_sign = sign;
+                        }
+                    }
+                }
+                if (best_distance == 0) {
+                    break;
+                }
+                v.pair_distance[k][p] = best_distance;
+                v.pair_sign[k][p] = best_sign;
+                v.num_pairs[k]++;
+                v.adders[k]++;
+                matchPairs<CFG::taps, digits>(d, best_distance, best_sign, 1 + p, v.terms[k], v.num_terms[k]);
+            }
+
+            for (int j = 0; j < CFG::taps; j++) {
+                for (int i = 0; i < digits; i++) {
+                    if (d[j][i] != 0) {
+                        term& t = v.terms[k][j][v.num_terms[k][j]++];
+                        t.source = 0;
+                        t.shift = i;
+                        t.sign = d[j][i];
+                    }
+                }
+                if (v.num_terms[k][j] > 1) {
+                    v.adders[k] += v.num_terms[k][j] - 1;
+                }
+            }
+        }
+        return v;
+    }
+
+    static constexpr value_t value = build();
+};
+
+template<class CFG, class TAPS, int PAIRS>
+constexpr typename plan<CFG, TAPS, PAIRS>::value_t plan<CFG, TAPS, PAIRS>::value;
+
+// Product of tap J of filter K: terms [FIRST, FIRST + N) summed as a balanced
+// adder tree. PROD_T holds the exact product; intermediate sums wrap modulo its
+// width, which cancels out because only left shifts and adds are involved.
+template<class PLAN, typename PROD_T, int K, int J, int FIRST, int N>
+struct term_tree {
+    static PROD_T sum(const PROD_T src[]) {
+#pragma HLS INLINE
+        return PROD_T(term_tree<PLAN, PROD_T, K, J, FIRST, N / 2>::sum(src) +
+                      term_tree<PLAN, PROD_T, K, J, FIRST + N / 2, N - N / 2>::sum(src));
+    }
+};
+
+template<class PLAN, typename PROD_T, int K, int J, int FIRST>
+struct term_tree<PLAN, PROD_T, K, J, FIRST, 1> {
+    static PROD_T sum(const PROD_T src[]) {
+#pragma HLS INLINE
+        constexpr term t = PLAN::value.terms[K][J][FIRST];
+        PROD_T shifted = src[t.source] << t.shift;
+        return t.sign > 0 ? shifted : PROD_T(-shifted);
+    }
+};
+
+template<class PLAN, typename PROD_T, int K, int J, int FIRST>
+struct term_tree<PLAN, PROD_T, K, J, FIRST, 0> {
+    static PROD_T sum(const PROD_T src[]) {
+#pragma HLS INLINE
+        return 0;
+    }
+};
+
+// Transposed-form partial sums z[J, J + N) of filter K. Updated in ascending
+// order, so z[J + 1] is still the value of the previous sample.
+template<class PLAN, typename PROD_T, typename ACC_T, int K, int J, int N>
+struct tap_chain {
+    static void update(const PROD_T src[], ACC_T z[]) {
+#pragma HLS INLINE
+        z[J] = term_tree<PLAN, PROD_T, K, J, 0, PLAN::value.num_terms[K][J]>::sum(src) + z[J + 1];
+        tap_chain<PLAN, PROD_T, ACC_T, K, J + 1, N - 1>::update(src, z);
+    }
+};
+
+template<class PLAN, typename PROD_T, typename ACC_T, int K, int J>
+struct tap_chain<PLAN, PROD_T, ACC_T, K, J, 1> {
+    static void update(const PROD_T src[], ACC_T z[]) {
+#pragma HLS INLINE
+        z[J] = term_tree<PLAN, PROD_T, K, J, 0, PLAN::value.num_terms[K][J]>::sum(src);
+    }
+};
+
+template<class PLAN, typename PROD_T, typename ACC_T, int K, int J>
+struct tap_chain<PLAN, PROD_T, ACC_T, K, J, 0> {
+    static void update(const PROD_T src[], ACC_T z[]) {
+#pragma HLS INLINE
+    }
+};
+
+} // namespace csd
+
+// Three real filters over re, im and re+im like three_real_mult, with the taps
+// compiled into CSD shift-add trees (see above). TAPS supplies the template as
+//   struct taps { static constexpr double value(int j, int k); };
+// with k indexing the three-real columns, e.g. a coeff::config_taps table
+// (pulseDetectorTaps.hpp). The adders are LUT
+// logic; only the magnitude squared still needs multipliers.
+template<class CFG, class TAPS, int PAIRS = 4>
+struct csd_shift_add {
+    typedef csd::plan<CFG, TAPS, PAIRS> plan;
+
+    typedef typename CFG::data_t data_t;
+    typedef typename CFG::acc_t acc_t;
+    // Filter input: re, im or re+im, exact
+    typedef ap_fixed<data_t::width + 1, data_t::iwidth + 1> input_t;
+    // Exact product of an input and a tap
+    typedef ap_fixed<input_t::width + CFG::coef_t::width, input_t::iwidth + CFG::coef_t::iwidth> prod_t;
+
+    // Filter K for one sample: returns the output and advances z, the
+    // partial sums of taps 1 .. taps-1 (z[0] is unused)
+    template<int K>
+    static acc_t filter(input_t x, acc_t z[CFG::taps]) {
+#pragma HLS INLINE
+        prod_t src[PAIRS + 1];
+#pragma HLS ARRAY_PARTITION variable=src complete dim=1
+
+        // x scaled by the tap LSB, then the shared pairs built from it
+        src[0] = prod_t(x) >> plan::frac;
+        for (int p = 0; p < PAIRS; p++) {
+#pragma HLS UNROLL
+            prod_t pair = src[0] << plan::value.pair_distance[K][p];
+            src[p + 1] = plan::value.pair_sign[K][p] > 0 ? prod_t(src[0] + pair) : prod_t(src[0] - pair);
+        }
+
+        acc_t y = csd::term_tree<plan, prod_t, K, 0, 0, plan::value.num_terms[K][0]>::sum(src) + z[1 % CFG::taps];
+        csd::tap_chain<plan, prod_t, acc_t, K, 1, CFG::taps - 1>::update(src, z);
+        return y;
+    }
+
+    static typename CFG::mag_t correlate(const typename CFG::complex_t& x, acc_t z[3][CFG::taps]) {
+#pragma HLS INLINE
+        acc_t conv_real = filter<0>(input_t(x.real()), z[0]);
+        acc_t conv_imag = filter<1>(input_t(x.imag()), z[1]);
+        acc_t conv_plus = filter<2>(input_t(x.real()) + input_t(x.imag()), z[2]);
+
+        return three_real_mult<CFG>::combine(conv_real, conv_imag, conv_plus);
+    }
+
+    // Single frame: the partial sums start cleared
+    static void matchFilter(typename CFG::complex_stream& RxSignal, typename CFG::real_stream& FilterOut) {
+        acc_t z[3][CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=z complete dim=0
+
+        for (int k = 0; k < 3; k++) {
+            for (int j = 0; j < CFG::taps; j++) {
+                z[k][j] = 0;
+            }
+        }
+
+        for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1
+            FilterOut.write(correlate(RxSignal.read(), z));
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+
+    // Continuous mode: the partial sums carry the previous frame's tail
+    static void matchFilterStream(typename CFG::complex_stream& RxSignal, typename CFG::real_stream& FilterOut) {
+        static acc_t z[3][CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=z complete dim=0
+
+        for (int i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1 rewind
+            FilterOut.write(correlate(RxSignal.read(), z));
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+
+    // Adds per sample of the three filters: shared pairs, product trees and
+    // the transposed chain
+    static int adders() {
+        int total = 0;
+        for (int k = 0; k < 3; k++) {
+            total += plan::value.adders[k] + CFG::taps - 1;
+        }
+        return total;
+    }
+
+    // The same without sharing, one term per nonzero CSD digit
+    static int addersUnshared() {
+        int total = 0;
+        for (int k = 0; k < 3; k++) {
+            total += plan::value.adders_unshared[k] + CFG::taps - 1;
+        }
+        return total;
+    }
+};
+
+} // namespace detector
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef PULSE_DETECTOR_DOPPLER_HPP
+#define PULSE_DETECTOR_DOPPLER_HPP
+
+#include "pulseDetectorCore.hpp"
+
+// Doppler filter bank: BINS three-real correlators, each with the template
+// shifted to one frequency offset, behind a single delay line. A return with
+// a frequency offset loses coherent gain in the unshifted correlator; the
+// bank keeps it within half a bin spacing. The delay line, the re + im
+// pre-adders and the control are built once for all branches, only the
+// multipliers and adder trees are per branch.
+namespace detector {
+
+// Best filter output of a frame, or of one sample: magnitude, sample and bin
+template<typename mag_t>
+struct doppler_record {
+    mag_t peak;
+    int location;
+    int doppler;
+};
+
+template<class CFG, int BINS>
+struct doppler_bank {
+    typedef typename three_real_mult<CFG>::tap_t tap_t;
+    typedef doppler_record<typename CFG::mag_t> record_t;
+    typedef hls::stream<record_t> record_stream;
+    // re + im is one bit wider than the sample, as in three_real_mult
+    typedef ap_fixed<CFG::data_t::width + 1, CFG::data_t::iwidth + 1> plus_t;
+
+    // Magnitude of every branch for the current delay line. The pre-add of
+    // each tap is taken once and shared by the branches.
+    static void correlate(const typename CFG::complex_t dataBuff[CFG::taps], const tap_t taps[BINS][CFG::taps],
+                          typename CFG::mag_t mag[BINS]) {
+#pragma HLS INLINE
+        typename CFG::acc_t conv_real[BINS], conv_imag[BINS], conv_plus[BINS];
+#pragma HLS ARRAY_PARTITION variable=conv_real complete dim=1
+#pragma HLS ARRAY_PARTITION variable=conv_imag complete dim=1
+#pragma HLS ARRAY_PARTITION variable=conv_plus complete dim=1
+        for (int d = 0; d < BINS; d++) {
+            conv_real[d] = 0;
+            conv_imag[d] = 0;
+            conv_plus[d] = 0;
+        }
+
+        for (int j = 0; j < CFG::taps; j++) {
+            typename CFG::data_t x_real = dataBuff[j].real();
+            typename CFG::data_t x_imag = dataBuff[j].imag();
+            plus_t x_plus = x_real + x_imag;
+            for (int d = 0; d < BINS; d++) {
+                conv_real[d] += x_real * taps[d][j][0];
+                conv_imag[d] += x_imag * taps[d][j][1];
+                conv_plus[d] += x_plus * taps[d][j][2];
+            }
+        }
+
+        for (int d = 0; d < BINS; d++) {
+            mag[d] = three_real_mult<CFG>::combine(conv_real[d], conv_imag[d], conv_plus[d]);
+        }
+    }
+
+    // Per sample, the strongest branch; the lower bin wins a tie
+    static void matchFilter(typename CFG::complex_stream& RxSignal, const tap_t taps[BINS][CFG::taps], record_stream& BankOut) {
+        typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+        for (int i = 0; i < CFG::taps; i++) {
+            dataBuff[i] = 0;
+        }
+
+        for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+            shiftIn<CFG, CFG::taps>(dataBuff, RxSignal.read());
+
+            typename CFG::mag_t mag[BINS];
+            correlate(dataBuff, taps, mag);
+
+            record_t best;
+            best.peak = mag[0];
+            best.location = n;
+            best.doppler = 0;
+            for (int d = 1; d < BINS; d++) {
+                if (mag[d] > best.peak) {
+                    best.peak = mag[d];
+                    best.doppler = d;
+                }
+            }
+            BankOut.write(best);
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+
+    // Joint argmax over (bin, sample): the earliest sample wins a tie, as in
+    // peakFinder
+    static void peakFinder(record_stream& BankOut, typename CFG::mag_t& peak, int& location, int& doppler) {
+        record_t current;
+        current.peak = 0;
+        current.location = 0;
+        current.doppler = 0;
+
+        for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+            record_t r = BankOut.read();
+            if (r.peak > current.peak) {
+                current = r;
+            }
+        }
+
+        peak = current.peak;
+        location = current.location;
+        doppler = current.doppler;
+    }
+};
+
+} // namespace detector
+
+#endif
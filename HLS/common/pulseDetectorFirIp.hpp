@@ -0,0 +1,168 @@
+#ifndef PULSE_DETECTOR_FIR_IP_HPP
+#define PULSE_DETECTOR_FIR_IP_HPP
+
+#include "pulseDetectorCore.hpp"
+#include <ap_int.h>
+#include <hls_fir.h> // Include FIR IP header
+#include <cstddef>
+#include <utility>
+
+namespace detector {
+
+typedef ap_uint<8> config_t;
+
+// Static parameters for the FIR filter IP. The three real filters of one
+// detector share everything but their taps; FILTER selects which of the three
+// (1: re+im, 2: re-im, 3: im). SETTINGS supplies input/output/coeff widths
+// and fractional bits, coeff_sets, num_channels, sample_period,
+// sample_frequency and the taps as
+//   static constexpr double coeff(int filter, int i);
+// entry i of the coefficient vector of FILTER, the sets back to back, e.g.
+// from a three_real_taps table (pulseDetectorTaps.hpp). coeff_vec is filled
+// from it at compile time.
+template<class CFG, class SETTINGS, int FILTER, class SEQ = std::make_index_sequence<CFG::taps * SETTINGS::coeff_sets> >
+struct fir_params;
+
+template<class CFG, class SETTINGS, int FILTER, std::size_t... I>
+struct fir_params<CFG, SETTINGS, FILTER, std::index_sequence<I...> > : hls::ip_fir::params_t {
+    static const unsigned num_channels = SETTINGS::num_channels;
+    static const unsigned total_num_coeff = CFG::taps * SETTINGS::coeff_sets;
+    static const double coeff_vec[total_num_coeff];
+    static const unsigned input_width = SETTINGS::input_width;
+    static const unsigned input_fractional_bits = SETTINGS::input_fractional_bits;
+    static const unsigned output_width = SETTINGS::output_width;
+    static const unsigned output_fractional_bits = SETTINGS::output_fractional_bits;
+    static const unsigned coeff_width = SETTINGS::coeff_width;
+    static const unsigned coeff_fractional_bits = SETTINGS::coeff_fractional_bits;
+    static const unsigned input_length = CFG::frame;
+    static const unsigned output_length = CFG::frame;
+    static const unsigned num_coeffs = CFG::taps;
+    static const unsigned coeff_sets = SETTINGS::coeff_sets;
+    static const unsigned quantization = 1;
+    static const unsigned rate_specification = 0;
+    static const unsigned hardware_oversampling_rate = 1;
+    static const unsigned sample_period = SETTINGS::sample_period;
+    static const unsigned sample_frequency = SETTINGS::sample_frequency;
+};
+
+template<class CFG, class SETTINGS, int FILTER, std::size_t... I>
+const double fir_params<CFG, SETTINGS, FILTER, std::index_sequence<I...> >::coeff_vec[fir_params::total_num_coeff] = {
+    SETTINGS::coeff(FILTER, I)...
+};
+
+// Three FIR IP cores over re, im and re+im with a front end that splits the
+// complex input and a back end that combines the outputs into the magnitude
+template<class CFG, class SETTINGS>
+struct fir_ip {
+    typedef fir_params<CFG, SETTINGS, 1> config1;
+    typedef fir_params<CFG, SETTINGS, 2> config2;
+    typedef fir_params<CFG, SETTINGS, 3> config3;
+
+    typedef ap_fixed<SETTINGS::input_width, SETTINGS::input_width - SETTINGS::input_fractional_bits> s_data_t;
+    typedef ap_fixed<SETTINGS::output_width, SETTINGS::output_width - SETTINGS::output_fractional_bits> m_data_t;
+
+    static void process_fe(typename CFG::complex_stream &in, hls::stream<s_data_t> &out1, hls::stream<s_data_t> &out2, hls::stream<s_data_t> &out3) {
+
+        for(unsigned i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1 rewind=true
+            std::complex<s_data_t> val = in.read();
+            out1.write(val.real());
+            out2.write(val.imag());
+            out3.write(val.real() + val.imag());
+        }
+    }
+
+    // Selects the coefficient set for the frame through the config channels
+    static void process_fe(typename CFG::complex_stream &in, config_t coeff_set, hls::stream<s_data_t> &out1, hls::stream<s_data_t> &out2, hls::stream<s_data_t> &out3,
+                           hls::stream<config_t> &cfg1, hls::stream<config_t> &cfg2, hls::stream<config_t> &cfg3) {
+
+        for(unsigned i = 0; i < CFG::frame; i++) {
+#pragma HLS PIPELINE II=1 rewind=true
+            if (i == 0) {
+                cfg1.write(coeff_set);
+                cfg2.write(coeff_set);
+                cfg3.write(coeff_set);
+            }
+            std::complex<s_data_t> val = in.read();
+            out1.write(val.real());
+            out2.write(val.imag());
+            out3.write(val.real() + val.imag());
+        }
+    }
+
+    static void process_be(hls::stream<m_data_t> &in1, hls::stream<m_data_t> &in2, hls::stream<m_data_t> &in3, typename CFG::real_stream &out) {
+
+        for(unsigned i = 0; i < CFG::frame; ++i) {
+#pragma HLS PIPELINE II=1 rewind=true
+
+            typename CFG::acc_t val1 = in1.read();
+            typename CFG::acc_t val2 = in2.read();
+            typename CFG::acc_t val3 = in3.read();
+            typename CFG::acc_t real = val1 - val3;
+            typename CFG::acc_t imag = val2 + val3;
+            DETECTOR_PROBE_VALUE(real, typename CFG::acc_t, double(val1) - double(val3));
+            DETECTOR_PROBE_VALUE(imag, typename CFG::acc_t, double(val2) + double(val3));
+            DETECTOR_PROBE_VALUE(mag, typename CFG::mag_t, double(real * real + imag * imag));
+            out.write(real * real + imag * imag);
+        }
+        DETECTOR_PROBE_FRAME();
+    }
+
+    // Single coefficient set, no config channel
+    static void matchFilter(typename CFG::complex_stream& RxSignal, typename CFG::real_stream& FilterOut) {
+#pragma HLS DATAFLOW
+
+        // Create FIR instances
+        static hls::FIR<config1> fir1;
+        static hls::FIR<config2> fir2;
+        static hls::FIR<config3> fir3;
+
+        hls::stream<s_data_t> fe1_out, fe2_out, fe3_out;
+#pragma HLS STREAM variable=fe1_out depth=2
+#pragma HLS STREAM variable=fe2_out depth=2
+#pragma HLS STREAM variable=fe3_out depth=2
+        hls::stream<m_data_t> be1_out, be2_out, be3_out;
+#pragma HLS STREAM variable=be1_out depth=2
+#pragma HLS STREAM variable=be2_out depth=2
+#pragma HLS STREAM variable=be3_out depth=2
+
+        process_fe(RxSignal, fe1_out, fe2_out, fe3_out);
+        fir1.run(fe1_out, be1_out);
+        fir2.run(fe2_out, be2_out);
+        fir3.run(fe3_out, be3_out);
+        process_be(be1_out, be2_out, be3_out, FilterOut);
+    }
+
+    // One of SETTINGS::coeff_sets template sets, selected per frame
+    static void matchFilter(typename CFG::complex_stream& RxSignal, config_t coeff_set, typename CFG::real_stream& FilterOut) {
+#pragma HLS DATAFLOW
+
+        // Create FIR instances
+        static hls::FIR<config1> fir1;
+        static hls::FIR<config2> fir2;
+        static hls::FIR<config3> fir3;
+
+        hls::stream<s_data_t> fe1_out, fe2_out, fe3_out;
+#pragma HLS STREAM variable=fe1_out depth=2
+#pragma HLS STREAM variable=fe2_out depth=2
+#pragma HLS STREAM variable=fe3_out depth=2
+        hls::stream<m_data_t> be1_out, be2_out, be3_out;
+#pragma HLS STREAM variable=be1_out depth=2
+#pragma HLS STREAM variable=be2_out depth=2
+#pragma HLS STREAM variable=be3_out depth=2
+        hls::stream<config_t> cfg1, cfg2, cfg3;
+#pragma HLS STREAM variable=cfg1 depth=2
+#pragma HLS STREAM variable=cfg2 depth=2
+#pragma HLS STREAM variable=cfg3 depth=2
+
+        process_fe(RxSignal, coeff_set, fe1_out, fe2_out, fe3_out, cfg1, cfg2, cfg3);
+        fir1.run(fe1_out, be1_out, cfg1);
+        fir2.run(fe2_out, be2_out, cfg2);
+        fir3.run(fe3_out, be3_out, cfg3);
+        process_be(be1_out, be2_out, be3_out, FilterOut);
+    }
+};
+
+} // namespace detector
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef PULSE_DETECTOR_PROBE_HPP
+#define PULSE_DETECTOR_PROBE_HPP
+
+// Overflow instrumentation of the fixed-point datapath, for C simulation
+// only. Built with DETECTOR_PROBES defined (add_files -cflags
+// "-DDETECTOR_PROBES", or PROBES in run_hls.tcl), every probed node records
+// the exact value it should hold, before AP_TRN / AP_WRAP, against the range
+// of its ap_fixed type:
+//   wraps       the value left the range, so the node holds a wrapped value;
+//               for a sum, the final value
+//   transients  a partial sum left the range but the final sum did not. With
+//               AP_WRAP the sum is still right, since wrapping is modular, but
+//               a saturating (AP_SAT) accumulator would corrupt it.
+// The largest |x| of each node is kept per frame, and a report goes to stdout
+// at the end of the run (or on report()). Synthesis (__SYNTHESIS__) and builds
+// without DETECTOR_PROBES compile every probe to nothing. The type argument of
+// a probe must be a typedef, since a comma splits macro arguments.
+#if defined(DETECTOR_PROBES) && !defined(__SYNTHESIS__)
+#define DETECTOR_PROBES_ENABLED 1
+#else
+#define DETECTOR_PROBES_ENABLED 0
+#endif
+
+#if DETECTOR_PROBES_ENABLED
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace detector {
+namespace probe {
+
+struct node_stats {
+    std::string name;
+    int width;
+    int int_bits;
+    long values;
+    long wraps;
+    long transients;
+    bool partial_out;          // a partial sum of the current value left the range
+    double max_abs;
+    double frame_max_abs;      // of the open frame
+    long frame_wraps;
+    std::vector<double> frame_max;  // per closed frame
+    std::vector<long> frame_wrap_count;
+
+    // Two's complement range of ap_fixed<width, int_bits>
+    bool inRange(double x) const {
+        double lsb = std::ldexp(1.0, int_bits - width);
+        double top = std::ldexp(1.0, int_bits - 1);
+        return x >= -top && x <= top - lsb;
+    }
+
+    void partial(double exact) {
+        if (!inRange(exact)) {
+            partial_out = true;
+        }
+    }
+
+    void value(double exact) {
+        double mag = std::fabs(exact);
+        values++;
+        if (!inRange(exact)) {
+            wraps++;
+            frame_wraps++;
+        } else if (partial_out) {
+            transients++;
+        }
+        partial_out = false;
+        if (mag > max_abs) {
+            max_abs = mag;
+        }
+        if (mag > frame_max_abs) {
+            frame_max_abs = mag;
+        }
+    }
+};
+
+class registry {
+public:
+    static registry& instance() {
+        static registry r;
+        return r;
+    }
+
+    // Nodes are looked up by name once per probe site, so a node probed from
+    // several functions or instantiations is one entry
+    node_stats& node(const char* name, int width, int int_bits) {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->name == name) {
+                return *nodes[i];
+            }
+        }
+        node_stats* n = new node_stats();
+        n->name = name;
+        n->width = width;
+        n->int_bits = int_bits;
+        n->values = n->wraps = n->transients = n->frame_wraps = 0;
+        n->partial_out = false;
+        n->max_abs = n->frame_max_abs = 0;
+        n->frame_max.assign(frames, 0.0);
+        n->frame_wrap_count.assign(frames, 0);
+        nodes.push_back(n);
+        return *n;
+    }
+
+    // Close the frame of every node
+    void endFrame() {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            node_stats& n = *nodes[i];
+            n.frame_max.push_back(n.frame_max_abs);
+            n.frame_wrap_count.push_back(n.frame_wraps);
+            n.frame_max_abs = 0;
+            n.frame_wraps = 0;
+        }
+        frames++;
+    }
+
+    int numFrames() const { return frames; }
+    int numNodes() const { return (int)nodes.size(); }
+    const node_stats& operator[](int i) const { return *nodes[i]; }
+
+    const node_stats* find(const char* name) const {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->name == name) {
+                return nodes[i];
+            }
+        }
+        return NULL;
+    }
+
+    // Per node: the format, the counts, the largest |x| and the integer bits
+    // it needs (spare > 0 is headroom that can be trimmed, < 0 a shortfall),
+    // then the largest |x| and wrap count of every frame
+    void report(std::ostream& out) {
+        char line[160];
+        reported = true;
+        out << "Overflow probes, " << frames << " frames" << std::endl;
+        std::snprintf(line, sizeof(line), "%-16s %-10s %10s %8s %10s %12s %6s %6s", "node", "format", "values", "wraps",
+                      "transients", "max |x|", "needs", "spare");
+        out << line << std::endl;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const node_stats& n = *nodes[i];
+            int needs = intBits(n.max_abs);
+            char format[24];
+            std::snprintf(format, sizeof(format), "<%d,%d>", n.width, n.int_bits);
+            std::snprintf(line, sizeof(line), "%-16s %-10s %10ld %8ld %10ld %12.6g %6d %6d", n.name.c_str(), format, n.values,
+                          n.wraps, n.transients, n.max_abs, needs, n.int_bits - needs);
+            out << line << std::endl;
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const node_stats& n = *nodes[i];
+            out << n.name << " per frame (max |x|/wraps):";
+            for (size_t f = 0; f < n.frame_max.size(); f++) {
+                out << " " << n.frame_max[f] << "/" << n.frame_wrap_count[f];
+            }
+            out << std::endl;
+        }
+    }
+
+    // Clears the counts; the nodes stay registered with their probe sites
+    void reset() {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            node_stats& n = *nodes[i];
+            n.values = n.wraps = n.transients = n.frame_wraps = 0;
+            n.partial_out = false;
+            n.max_abs = n.frame_max_abs = 0;
+            n.frame_max.clear();
+            n.frame_wrap_count.clear();
+        }
+        frames = 0;
+    }
+
+    // Smallest signed integer bit count holding +/-x
+    static int intBits(double x) {
+        int exponent;
+        if (x <= 0) {
+            return 0;
+        }
+        std::frexp(x, &exponent); // x < 2^exponent
+        return exponent + 1;
+    }
+
+    ~registry() {
+        if (!reported && !nodes.empty()) {
+            report(std::cout);
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            delete nodes[i];
+        }
+    }
+
+private:
+    registry() : frames(0), reported(false) {}
+
+    std::vector<node_stats*> nodes;
+    int frames;
+    bool reported;
+};
+
+template<typename T>
+node_stats& node(const char* name) {
+    return registry::instance().node(name, T::width, T::iwidth);
+}
+
+inline void endFrame() {
+    registry::instance().endFrame();
+}
+
+inline void report(std::ostream& out) {
+    registry::instance().report(out);
+}
+
+} // namespace probe
+} // namespace detector
+
+// Running sum: declare the exact shadow of VAR, add each term, close with the
+// final value. Nodes are named after the variable.
+#define DETECTOR_PROBE_SUM(VAR) double VAR##_exact = 0
+#define DETECTOR_PROBE_ADD(VAR, T, TERM)                                                          \
+    do {                                                                                          \
+        static detector::probe::node_stats& probe_node_ = detector::probe::node<T>(#VAR);         \
+        VAR##_exact += (double)(TERM);                                                            \
+        probe_node_.partial(VAR##_exact);                                                         \
+    } while (0)
+#define DETECTOR_PROBE_END(VAR, T) DETECTOR_PROBE_VALUE(VAR, T, VAR##_exact)
+// One value of node NAME of type T
+#define DETECTOR_PROBE_VALUE(NAME, T, EXACT)                                                      \
+    do {                                                                                          \
+        static detector::probe::node_stats& probe_node_ = detector::probe::node<T>(#NAME);        \
+        probe_node_.value(EXACT);                                                                 \
+    } while (0)
+#define DETECTOR_PROBE_FRAME() detector::probe::endFrame()
+
+#else
+
+#define DETECTOR_PROBE_SUM(VAR)
+#define DETECTOR_PROBE_ADD(VAR, T, TERM)
+#define DETECTOR_PROBE_END(VAR, T)
+#define DETECTOR_PROBE_VALUE(NAME, T, EXACT)
+#define DETECTOR_PROBE_FRAME()
+
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PULSE_DETECTOR_REPLAY_HPP
+#define PULSE_DETECTOR_REPLAY_HPP
+
+#include "pulseDetectorCore.hpp"
+
+// Multi-waveform detection on one correlator: each frame is stored in BRAM
+// and replayed once per template through a single three-real correlator, with
+// the templates in a ROM indexed by waveform ID. The replay takes
+// WAVEFORMS * frame cycles, so the core clock must be at least WAVEFORMS times
+// the sample rate; the capture side then stalls on the input stream between
+// samples. In DATAFLOW the frame buffer is a ping-pong, so the next frame is
+// captured while the previous one is replayed.
+namespace detector {
+
+template<class CFG, int WAVEFORMS>
+struct waveform_replay {
+    typedef typename three_real_mult<CFG>::tap_t tap_t;
+
+    static void captureFrame(typename CFG::complex_stream& RxSignal, typename CFG::complex_t frameBuf[CFG::frame]) {
+        for (int n = 0; n < CFG::frame; n++) {
+#pragma HLS PIPELINE II=1
+            frameBuf[n] = RxSignal.read();
+        }
+    }
+
+    // One pass per waveform, flattened into a single II=1 loop. The delay
+    // line is cleared at the start of each pass, so every pass is the
+    // single-frame correlator of its template. The best pass wins; the lower
+    // waveform ID wins a tie, and within a pass the earliest sample.
+    static void replayFrame(const typename CFG::complex_t frameBuf[CFG::frame], const tap_t rom[WAVEFORMS][CFG::taps],
+                            typename CFG::mag_t& peak, int& location, int& waveform) {
+        typename CFG::complex_t dataBuff[CFG::taps];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+#pragma HLS ARRAY_PARTITION variable=rom complete dim=2
+#pragma HLS ARRAY_PARTITION variable=rom complete dim=3
+
+        typename CFG::mag_t current_peak = 0;
+        int current_location = 0;
+        int current_waveform = 0;
+
+        int w = 0;
+        int n = 0;
+        for (int k = 0; k < WAVEFORMS * CFG::frame; k++) {
+#pragma HLS PIPELINE II=1
+            if (n == 0) {
+                for (int j = 0; j < CFG::taps; j++) {
+                    dataBuff[j] = 0;
+                }
+            }
+            shiftIn<CFG, CFG::taps>(dataBuff, frameBuf[n]);
+            typename CFG::mag_t magVal = three_real_mult<CFG>::template correlate<1>(dataBuff, rom[w]);
+
+            if (magVal > current_peak) {
+                current_peak = magVal;
+                current_location = n;
+                current_waveform = w;
+            }
+
+            if (n == CFG::frame - 1) {
+                n = 0;
+                w++;
+            } else {
+                n++;
+            }
+        }
+        DETECTOR_PROBE_FRAME();
+
+        peak = current_peak;
+        location = current_location;
+        waveform = current_waveform;
+    }
+};
+
+} // namespace detector
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef PULSE_DETECTOR_TAPS_HPP
+#define PULSE_DETECTOR_TAPS_HPP
+
+#include <cstddef>
+#include <utility>
+
+// Compile-time tap tables. A complex template (pulseDetectorTemplate.hpp) is
+// quantised to the tap word and split into the three-real form by constexpr
+// code, so the kernels need no testbench-generated include files and every
+// consumer sees the same words. Native C++ (C++14), so the host model uses
+// the same code with the word format given as integers.
+//
+// A template is a struct with a static length and a static constexpr
+// value(j, part), part 0 real and 1 imaginary; a tap table has a static
+// length and value(j, k) for column k of the three-real form.
+namespace detector {
+namespace coeff {
+
+// Two's complement WIDTH-bit word n, wrapped as ap_fixed's AP_WRAP does
+constexpr long long wrap(long long n, int width) {
+    long long full = 1LL << width;
+    n &= full - 1;
+    if (n >= full / 2) {
+        n -= full;
+    }
+    return n;
+}
+
+// Two's complement word of a WIDTH-bit coefficient with FRAC fractional
+// bits, rounded like ap_fixed's defaults: truncate, then wrap
+constexpr long long quantise(double v, int width, int frac) {
+    double scaled = v * (double)(1LL << frac);
+    long long n = (long long)scaled;
+    if ((double)n > scaled) {
+        n--;
+    }
+    return wrap(n, width);
+}
+
+// The complex conjugate of TEMPLATE, e.g. as a second coefficient set
+template<class TEMPLATE>
+struct conjugate {
+    static const int length = TEMPLATE::length;
+
+    static constexpr double value(int j, int part) {
+        return part == 0 ? TEMPLATE::value(j, 0) : -TEMPLATE::value(j, 1);
+    }
+};
+
+// Column k of the three-real form of the tap words re and im: re+im, re-im
+// or im, the sums wrapped into the WIDTH-bit word
+constexpr long long three_real_word(long long re, long long im, int k, int width) {
+    return k == 0 ? wrap(re + im, width) : k == 1 ? wrap(re - im, width) : im;
+}
+
+// Three-real form of TEMPLATE in ap_fixed<WIDTH, WIDTH - FRAC>: columns
+// re+im, re-im and im of the quantised taps, each sum wrapped into the tap
+// word as the fixed-point assignment does. Taps from the template's length
+// up to LENGTH are zero. Every value is a multiple of 2^-FRAC, so it converts
+// to the tap word exactly.
+template<class TEMPLATE, int LENGTH, int WIDTH, int FRAC>
+struct three_real_taps {
+    static const int length = LENGTH;
+    static_assert(LENGTH >= TEMPLATE::length, "the filter is shorter than the template");
+
+    static constexpr long long word(int j, int k) {
+        long long re = j < TEMPLATE::length ? quantise(TEMPLATE::value(j, 0), WIDTH, FRAC) : 0;
+        long long im = j < TEMPLATE::length ? quantise(TEMPLATE::value(j, 1), WIDTH, FRAC) : 0;
+        return three_real_word(re, im, k, WIDTH);
+    }
+
+    static constexpr double value(int j, int k) {
+        return (double)word(j, k) / (double)(1LL << FRAC);
+    }
+};
+
+// Three-real taps of TEMPLATE for a detector config: CFG::taps taps in
+// CFG::coef_t
+template<class CFG, class TEMPLATE>
+struct config_taps : three_real_taps<TEMPLATE, CFG::taps, CFG::coef_t::width, CFG::coef_t::width - CFG::coef_t::iwidth> {};
+
+// TAPS as a [length][3] array of T, e.g. the ROM of a compiled-in template
+template<typename T, class TAPS, class SEQ = std::make_index_sequence<TAPS::length> >
+struct tap_rom;
+
+template<typename T, class TAPS, std::size_t... J>
+struct tap_rom<T, TAPS, std::index_sequence<J...> > {
+    static const T value[sizeof...(J)][3];
+};
+
+template<typename T, class TAPS, std::size_t... J>
+const T tap_rom<T, TAPS, std::index_sequence<J...> >::value[sizeof...(J)][3] = {
+    {T(TAPS::value(J, 0)), T(TAPS::value(J, 1)), T(TAPS::value(J, 2))}...
+};
+
+// BANKS writable tap banks, bank 0 starting out with TAPS and the others 0
+template<typename T, class TAPS, int BANKS, class SEQ = std::make_index_sequence<TAPS::length> >
+struct tap_banks;
+
+template<typename T, class TAPS, int BANKS, std::size_t... J>
+struct tap_banks<T, TAPS, BANKS, std::index_sequence<J...> > {
+    static T value[BANKS][sizeof...(J)][3];
+};
+
+template<typename T, class TAPS, int BANKS, std::size_t... J>
+T tap_banks<T, TAPS, BANKS, std::index_sequence<J...> >::value[BANKS][sizeof...(J)][3] = {
+    {{T(TAPS::value(J, 0)), T(TAPS::value(J, 1)), T(TAPS::value(J, 2))}...}
+};
+
+// v quantised to ap_fixed<WIDTH, WIDTH - FRAC>, as a double
+constexpr double quantised(double v, int width, int frac) {
+    return (double)quantise(v, width, frac) / (double)(1LL << frac);
+}
+
+// sin and cos by their Taylor series, for |x| <= pi/4
+constexpr double taylor_sin(double x) {
+    double term = x;
+    double sum = x;
+    for (int k = 1; k < 12; k++) {
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double taylor_cos(double x) {
+    double term = 1;
+    double sum = 1;
+    for (int k = 1; k < 12; k++) {
+        term *= -x * x / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Part 0 cos and part 1 sin of 2*pi*turns. The angle is folded into the
+// first octant, so the axes and the diagonals come out exact and symmetric
+// whenever turns is an exact binary fraction.
+constexpr double unit_turn(double turns, int part) {
+    const double pi = 3.14159265358979323846;
+    long long whole = (long long)turns;
+    double r = turns - (double)(whole > turns ? whole - 1 : whole);
+    int quadrant = (int)(4 * r);
+    double rem = r - quadrant * 0.25;
+    bool upper = 8 * rem > 1;
+    double x = 2 * pi * (upper ? 0.25 - rem : rem);
+    double c = upper ? taylor_sin(x) : taylor_cos(x);
+    double s = upper ? taylor_cos(x) : taylor_sin(x);
+    double qc = quadrant == 0 ? c : quadrant == 1 ? -s : quadrant == 2 ? -c : s;
+    double qs = quadrant == 0 ? s : quadrant == 1 ? c : quadrant == 2 ? -s : -c;
+    return part == 0 ? qc : qs;
+}
+
+// Part 0 cos and part 1 sin of 2*pi*m/N
+constexpr double unit_root(long long m, long long n, int part) {
+    return unit_turn((double)(((m % n) + n) % n) / (double)n, part);
+}
+
+// Linear FM chirp of LENGTH taps at amplitude 1/4, sweeping from -1/8 to
+// +1/8 cycles per sample: a long template whose spectrum peaks near
+// sqrt(4 * LENGTH) / 4, far outside the tap word for LENGTH in the hundreds
+template<int LENGTH>
+struct lfm_chirp {
+    static const int length = LENGTH;
+
+    static constexpr double value(int j, int part) {
+        return unit_turn(((double)j * j / LENGTH - j) / 8, part) / 4;
+    }
+};
+
+// Radix-2 FFT twiddle factors W^m = exp(-j*2*pi*m/N) for m = 0 .. N/2-1 in
+// ap_fixed<WIDTH, WIDTH - FRAC>, part 0 real and 1 imaginary
+template<int N, int WIDTH, int FRAC>
+struct fft_twiddle {
+    static const int length = N / 2;
+
+    static constexpr double value(int m, int part) {
+        return quantised(unit_root(-m, N, part), WIDTH, FRAC);
+    }
+};
+
+// N-point spectrum of TEMPLATE, its taps quantised to ap_fixed<WIDTH,
+// WIDTH - FRAC> and zero-padded, in bit-reversed bin order: the order a
+// decimation-in-frequency FFT produces its output in. The bins are quantised
+// to ap_fixed<SPECTRUM_WIDTH, SPECTRUM_WIDTH - FRAC>; a bin can reach the sum
+// of the tap magnitudes, so a long template needs a wider word than its taps.
+template<class TEMPLATE, int N, int WIDTH, int FRAC, int SPECTRUM_WIDTH = WIDTH>
+struct fft_spectrum {
+    static const int length = N;
+    static_assert(N >= TEMPLATE::length, "the FFT is shorter than the template");
+
+    static constexpr int bit_reverse(int k) {
+        int r = 0;
+        for (int n = 1; n < N; n <<= 1) {
+            r = (r << 1) | (k & 1);
+            k >>= 1;
+        }
+        return r;
+    }
+
+    static constexpr double value(int k, int part) {
+        int bin = bit_reverse(k);
+        double spectrum_real = 0;
+        double spectrum_imag = 0;
+        for (int j = 0; j < TEMPLATE::length; j++) {
+            double tap_real = quantised(TEMPLATE::value(j, 0), WIDTH, FRAC);
+            double tap_imag = quantised(TEMPLATE::value(j, 1), WIDTH, FRAC);
+            double c = unit_root(-(long long)bin * j, N, 0);
+            double s = unit_root(-(long long)bin * j, N, 1);
+            spectrum_real += tap_real * c - tap_imag * s;
+            spectrum_imag += tap_real * s + tap_imag * c;
+        }
+        return quantised(part == 0 ? spectrum_real : spectrum_imag, SPECTRUM_WIDTH, FRAC);
+    }
+};
+
+// Doppler bank of TEMPLATE: GRID::bins copies shifted in frequency, bin d by
+// (d - bins / 2) * GRID::spacing cycles over LENGTH taps, bin bins / 2
+// unshifted. The taps are quantised to ap_fixed<WIDTH, WIDTH - FRAC>, rotated,
+// quantised again and split into the three-real form; taps from the
+// template's length up to LENGTH are zero.
+template<class TEMPLATE, class GRID, int LENGTH, int WIDTH, int FRAC>
+struct doppler_taps {
+    static const int bins = GRID::bins;
+    static const int length = LENGTH;
+    static_assert(LENGTH >= TEMPLATE::length, "the filter is shorter than the template");
+
+    // Part 0 real and 1 imaginary of shifted tap j of bin d, as a word
+    static constexpr long long shifted(int d, int j, int part) {
+        double tap_real = j < TEMPLATE::length ? quantised(TEMPLATE::value(j, 0), WIDTH, FRAC) : 0;
+        double tap_imag = j < TEMPLATE::length ? quantised(TEMPLATE::value(j, 1), WIDTH, FRAC) : 0;
+        double turns = (d - GRID::bins / 2) * GRID::spacing * j / LENGTH;
+        double c = unit_turn(turns, 0);
+        double s = unit_turn(turns, 1);
+        return quantise(part == 0 ? tap_real * c - tap_imag * s : tap_real * s + tap_imag * c, WIDTH, FRAC);
+    }
+
+    static constexpr double value(int d, int j, int k) {
+        return (double)three_real_word(shifted(d, j, 0), shifted(d, j, 1), k, WIDTH) / (double)(1LL << FRAC);
+    }
+};
+
+// Square root by Newton's method, for v >= 0
+constexpr double newton_sqrt(double v) {
+    double x = v > 1 ? v : 1;
+    for (int i = 0; i < 64; i++) {
+        x = (x + v / x) / 2;
+    }
+    return v > 0 ? x : 0;
+}
+
+// Waveform set for time-shared replay: WAVEFORMS templates of LENGTH taps,
+// waveform 0 TEMPLATE, 1 its conjugate and the rest pseudo-random QPSK codes
+// at the RMS tap amplitude of TEMPLATE. The code chips are the top two bits
+// of successive states of the LCG x' = 1664525 x + 1013904223 seeded with
+// SEED, code after code. The taps are quantised to ap_fixed<WIDTH, WIDTH -
+// FRAC> and split into the three-real form.
+template<class TEMPLATE, int WAVEFORMS, int LENGTH, int WIDTH, int FRAC, unsigned SEED>
+struct waveform_taps {
+    static const int bins = WAVEFORMS;
+    static const int length = LENGTH;
+    static_assert(LENGTH >= TEMPLATE::length, "the filter is shorter than the template");
+
+    static constexpr double code_amplitude() {
+        double energy = 0;
+        for (int j = 0; j < TEMPLATE::length; j++) {
+            double tap_real = quantised(TEMPLATE::value(j, 0), WIDTH, FRAC);
+            double tap_imag = quantised(TEMPLATE::value(j, 1), WIDTH, FRAC);
+            energy += tap_real * tap_real + tap_imag * tap_imag;
+        }
+        return newton_sqrt(energy / LENGTH / 2);
+    }
+
+    // Part 0 real and 1 imaginary of tap j of waveform w, as a word. The
+    // conjugate negates the quantised template.
+    static constexpr long long word(int w, int j, int part) {
+        if (w < 2) {
+            long long n = j < TEMPLATE::length ? quantise(TEMPLATE::value(j, part), WIDTH, FRAC) : 0;
+            return w == 1 && part == 1 ? wrap(-n, WIDTH) : n;
+        }
+        unsigned state = SEED;
+        for (int n = 0; n <= (w - 2) * LENGTH + j; n++) {
+            state = state * 1664525u + 1013904223u;
+        }
+        return quantise((state >> (30 + part)) & 1 ? code_amplitude() : -code_amplitude(), WIDTH, FRAC);
+    }
+
+    static constexpr double tap(int w, int j, int part) {
+        return (double)word(w, j, part) / (double)(1LL << FRAC);
+    }
+
+    static constexpr double value(int w, int j, int k) {
+        return (double)three_real_word(word(w, j, 0), word(w, j, 1), k, WIDTH) / (double)(1LL << FRAC);
+    }
+};
+
+// BANK as a [bins][length][3] array of T, e.g. the ROM of a Doppler bank or
+// of a waveform set. The initialiser is flat and fills the array in
+// row-major order.
+template<typename T, class BANK, class SEQ = std::make_index_sequence<BANK::bins * BANK::length * 3> >
+struct bank_rom;
+
+template<typename T, class BANK, std::size_t... I>
+struct bank_rom<T, BANK, std::index_sequence<I...> > {
+    static const T value[BANK::bins][BANK::length][3];
+};
+
+template<typename T, class BANK, std::size_t... I>
+const T bank_rom<T, BANK, std::index_sequence<I...> >::value[BANK::bins][BANK::length][3] = {
+    T(BANK::value(I / (3 * BANK::length), I / 3 % BANK::length, I % 3))...
+};
+
+// TABLE as a [length][2] array of T (real, imaginary)
+template<typename T, class TABLE, class SEQ = std::make_index_sequence<TABLE::length> >
+struct complex_rom;
+
+template<typename T, class TABLE, std::size_t... J>
+struct complex_rom<T, TABLE, std::index_sequence<J...> > {
+    static const T value[sizeof...(J)][2];
+};
+
+template<typename T, class TABLE, std::size_t... J>
+const T complex_rom<T, TABLE, std::index_sequence<J...> >::value[sizeof...(J)][2] = {
+    {T(TABLE::value(J, 0)), T(TABLE::value(J, 1))}...
+};
+
+} // namespace coeff
+} // namespace detector
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef PULSE_DETECTOR_TEMPLATE_HPP
+#define PULSE_DETECTOR_TEMPLATE_HPP
+
+// The transmitted pulse, the MATLAB template (CorrFilter_in.txt) at full
+// precision. It is the single source of the compiled-in taps: the three-real
+// filters, the FIR IP coefficient sets, the CSD trees and the host model all
+// derive theirs from it at compile time (pulseDetectorTaps.hpp), so a new
+// waveform only needs this table replaced. Native C++, no HLS types.
+namespace detector {
+
+struct recorded_template {
+    static const int length = 64;
+
+    // Part 0 is the real and part 1 the imaginary part of sample j
+    static constexpr double value(int j, int part) {
+        constexpr double samples[length][2] = {
+            {-0.00491451498832889, 0.0148319980929574},
+            {-0.0156140563600067, 0.000584695635809877},
+            {-0.0005001263530632, -0.0156169939050693},
+            {0.00012439194243945, 0.0156245048447833},
+            {0.00255942091045597, -0.0154139543791696},
+            {-0.0134356942845571, 0.0079763866563702},
+            {-0.00840424259086098, -0.0131722940854643},
+            {0.015127841039654, 0.00391012154273517},
+            {-0.0156241745610788, -0.000160605992850734},
+            {0.0114572695493827, -0.010624104643347},
+            {0.00815468496051051, -0.0133282308726561},
+            {-0.00877459334402296, 0.0129285396177228},
+            {-0.00667920137477977, 0.0141254696911338},
+            {-0.00254363482493964, -0.0154165672857921},
+            {0.000460047433128621, 0.0156182259350821},
+            {-0.0039461468884332, 0.0151184837115006},
+            {-0.00947449346331245, 0.0124247574871162},
+            {-0.0147206566601779, -0.00523859642396309},
+            {-0.015592698176364, -0.00100418553107231},
+            {0.00603628783316075, -0.0144119344362662},
+            {0.00437807859035895, 0.014999101734992},
+            {0.00152094494672881, 0.0155507990620746},
+            {-0.0114943235703699, -0.0105840044718263},
+            {-0.014481926415375, -0.00586638153376192},
+            {0.0152604698574489, -0.0033553963595814},
+            {0.0148669800470372, 0.00480765319891083},
+            {-0.00639405428532113, -0.0142568122242094},
+            {-0.00530860715718025, 0.0146955542614334},
+            {0.00695837017685913, 0.0139900575224621},
+            {0.0128043414236097, -0.00895485710146357},
+            {0.0149720984688655, -0.00446955170443244},
+            {-0.00263056987155062, -0.0154019715345436},
+            {0.0153135040434069, -0.00310438704297022},
+            {-0.00426052094561949, 0.0150329167586313},
+            {0.00742510067837592, -0.0137480364021915},
+            {-0.0087437093058065, 0.0129494468057733},
+            {-0.0121774508112518, -0.0097903174994248},
+            {-0.000674009161212342, 0.015610456003929},
+            {0.000759586039096927, 0.0156065260083469},
+            {-0.00676494785413363, 0.0140846052671295},
+            {0.0143003762227151, 0.00629601976559832},
+            {0.00911485254502216, 0.0126909451217198},
+            {0.0152333055812274, -0.0034766400545563},
+            {-0.00872231426436422, 0.0129638674350546},
+            {0.0151216425037619, 0.00393402503657776},
+            {0.00409529496340637, 0.0150787660026508},
+            {0.0134857083094418, 0.00789153320924731},
+            {-0.0137747534817633, -0.0073754180570765},
+            {0.00981636162945908, -0.0121564661542606},
+            {0.00485457033778858, 0.0148517262240947},
+            {-0.0155590830062598, -0.00143372277805659},
+            {0.0150625487397285, 0.00415454575896139},
+            {0.01535903669258, 0.00287064746633593},
+            {0.00856920042747379, -0.0130655818482677},
+            {0.015246308517476, 0.00341916679761899},
+            {0.0150713867260501, 0.00412236911906737},
+            {-0.0149520069448514, 0.00453631054063949},
+            {-0.00278287934399932, -0.0153751815454889},
+            {0.012781308019863, -0.00898770217026495},
+            {-0.0105260369796126, 0.0115474313379135},
+            {0.0133672286780518, 0.00809060087191736},
+            {0.0109097612762032, -0.0111856038681985},
+            {0.012966674801848, 0.00871814025943146},
+            {0.00618053049903616, 0.0143506678503296}
+        };
+        return samples[j][part];
+    }
+};
+
+} // namespace detector
+
+#endif
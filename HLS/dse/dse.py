@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""Design-space exploration over variants, clocks, filter lengths, word widths and filter forms.
+
+sweep   generates one project per design point from run_hls_dse.tcl, runs
+        vitis_hls on it (unless --dry-run) and reports the points
+report  parses existing vitis_hls.log files, e.g. the checked-in ones,
+        without a vendor toolchain
+
+Both print every point and the Pareto front of throughput against DSP, LUT
+and FF. Throughput is samples per clock times the lower of the target clock
+and the achieved clock. The achieved clock comes from the post-implementation
+critical path, or the post-synthesis one, or the HLS Estimated Fmax.
+
+    python3 dse.py sweep --variants resource_opt3,resource_opt4 --clocks 256MHz,300MHz \\
+        --filter-lengths 64,96 --widths 16,18 --forms 0,1,2 -j 4 --out dse.csv
+    python3 dse.py report ../*/vitis_hls.log
+"""
+
+import argparse
+import concurrent.futures
+import csv
+import os
+import re
+import subprocess
+import sys
+
+HLS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DSE_TCL = os.path.join(HLS_DIR, 'dse', 'run_hls_dse.tcl')
+
+DEFAULT_PART = 'xc7z035-fbg676-1'
+DEFAULT_FILTER_LENGTH = 64
+DEFAULT_WIDTH = 18
+RESOURCES = ['LUT', 'FF', 'DSP', 'BRAM', 'SRL']
+
+FIELDS = ['point', 'variant', 'top', 'part', 'target_mhz', 'filter_length', 'data_width', 'filter_form',
+          'samples_per_clock',
+          'hls_fmax_mhz', 'cp_synth_ns', 'cp_impl_ns', 'timing_met', 'achieved_mhz', 'throughput_msps',
+          'resource_stage'] + RESOURCES + ['pareto']
+
+
+def parse_log(text):
+    """Timing and resource figures of one vitis_hls.log; the last occurrence of each wins."""
+    result = {'hls_fmax_mhz': None, 'cp_synth_ns': None, 'cp_impl_ns': None, 'timing_met': None, 'target_mhz': None,
+              'part': None, 'top': None, 'resource_stage': None}
+    resources = {}
+    for line in text.splitlines():
+        m = re.search(r'Estimated Fmax:\s*([\d.]+)\s*MHz', line)
+        if m:
+            result['hls_fmax_mhz'] = float(m.group(1))
+            continue
+        m = re.match(r'CP achieved post-synthesis:\s*([\d.]+)', line)
+        if m:
+            result['cp_synth_ns'] = float(m.group(1))
+            continue
+        m = re.match(r'CP achieved post-implementation:\s*([\d.]+)', line)
+        if m:
+            result['cp_impl_ns'] = float(m.group(1))
+            continue
+        if line.startswith('Timing met'):
+            result['timing_met'] = True
+            continue
+        if line.startswith('Timing not met'):
+            result['timing_met'] = False
+            continue
+        m = re.search(r"Setting up clock 'default' with a period of ([\d.]+)\s*ns", line)
+        if m:
+            result['target_mhz'] = round(1000.0 / float(m.group(1)), 1)
+            continue
+        m = re.search(r'Running: set_part (\S+)', line)
+        if m:
+            result['part'] = m.group(1)
+            continue
+        m = re.search(r'Running: set_top (\S+)', line)
+        if m:
+            result['top'] = m.group(1)
+            continue
+        # HLS EXTRACTION: synth|impl resources_dict: AVAIL_LUT 171900 LUT 2547 ...
+        m = re.match(r'HLS EXTRACTION: (synth|impl) resources_dict:(.*)', line)
+        if m:
+            tokens = m.group(2).split()
+            values = dict(zip(tokens[0::2], tokens[1::2]))
+            stage = m.group(1)
+            # impl figures supersede synth figures
+            if stage == 'impl' or result['resource_stage'] != 'impl':
+                result['resource_stage'] = stage
+                resources = {k: int(values[k]) for k in RESOURCES if k in values}
+    result.update(resources)
+    return result
+
+
+def achieved_mhz(point):
+    if point.get('cp_impl_ns'):
+        return round(1000.0 / point['cp_impl_ns'], 2)
+    if point.get('cp_synth_ns'):
+        return round(1000.0 / point['cp_synth_ns'], 2)
+    return point.get('hls_fmax_mhz')
+
+
+def finish_point(point):
+    """Derive achieved clock and throughput in place."""
+    point['achieved_mhz'] = achieved_mhz(point)
+    point['throughput_msps'] = None
+    if point['achieved_mhz']:
+        clock = min(c for c in (point.get('target_mhz'), point['achieved_mhz']) if c)
+        point['throughput_msps'] = round(point['samples_per_clock'] * clock, 2)
+    return point
+
+
+def dominates(a, b):
+    """a is at least as good as b everywhere and better somewhere: more throughput, fewer DSP/LUT/FF."""
+    keys = [('throughput_msps', 1), ('DSP', -1), ('LUT', -1), ('FF', -1)]
+    no_worse = all(sign * a[k] >= sign * b[k] for k, sign in keys)
+    better = any(sign * a[k] > sign * b[k] for k, sign in keys)
+    return no_worse and better
+
+
+def pareto(points):
+    """Mark each complete point with pareto=True/False and return the front."""
+    complete = [p for p in points if p.get('throughput_msps') is not None and all(p.get(k) is not None
+                                                                                  for k in ('DSP', 'LUT', 'FF'))]
+    for p in points:
+        p['pareto'] = p in complete and not any(dominates(q, p) for q in complete if q is not p)
+    return [p for p in points if p['pareto']]
+
+
+def header_define(variant_dir, macro, default):
+    """Value of #define macro in the variant header."""
+    with open(os.path.join(variant_dir, 'pulseDetector.hpp')) as f:
+        m = re.search(r'^#define %s (\d+)' % macro, f.read(), re.M)
+    return int(m.group(1)) if m else default
+
+
+def samples_per_clock(variant_dir):
+    """Samples the pulseDetector top takes per clock: SSR_FACTOR for a super-sample-rate variant,
+    1/sample_period where the filter runs on FIR IP cores (fir_settings), 1 otherwise."""
+    ssr = header_define(variant_dir, 'SSR_FACTOR', None)
+    if ssr is not None:
+        return ssr
+    with open(os.path.join(variant_dir, 'pulseDetector.hpp')) as f:
+        m = re.search(r'\bsample_period = (\d+);', f.read())
+    # resource_opt6 only uses its FIR IP settings with MATCH_FILTER_FIR_IP 1
+    if m and header_define(variant_dir, 'MATCH_FILTER_FIR_IP', 1):
+        return 1.0 / int(m.group(1))
+    return 1
+
+
+def overridable(variant_dir, macro):
+    with open(os.path.join(variant_dir, 'pulseDetector.hpp')) as f:
+        return ('#ifndef %s' % macro) in f.read()
+
+
+def parse_clock(clock):
+    """'300MHz' or '3.333' (ns) to MHz."""
+    m = re.match(r'([\d.]+)\s*MHz$', clock, re.I)
+    return float(m.group(1)) if m else round(1000.0 / float(clock), 2)
+
+
+def run_point(args, variant, clock, filter_length, width, form):
+    variant_dir = os.path.join(HLS_DIR, variant)
+    name = '%s_%s_t%d_w%d' % (variant, clock, filter_length, width)
+    if form is not None:
+        name += '_f%d' % form
+    point_dir = os.path.join(os.path.abspath(args.build_dir), name)
+    os.makedirs(point_dir, exist_ok=True)
+
+    # resource_opt7 recodes its taps with constexpr code
+    cflags = ['-std=c++14', '-DFILTER_LENGTH=%d' % filter_length, '-DDATA_WIDTH=%d' % width]
+    if form is not None:
+        cflags.append('-DMATCH_FILTER_FORM=%d' % form)
+    cmd = [args.vitis_hls, '-f', DSE_TCL, '-tclargs', variant_dir, clock, args.part, args.top,
+           '1' if args.impl else '0'] + cflags
+    log_path = os.path.join(point_dir, 'vitis_hls.log')
+    if args.dry_run:
+        sys.stderr.write('(cd %s && %s)\n' % (point_dir, ' '.join(cmd)))
+    else:
+        with open(os.devnull, 'w') as devnull:
+            subprocess.run(cmd, cwd=point_dir, stdout=devnull, stderr=subprocess.STDOUT)
+
+    point = {'point': name, 'variant': variant, 'top': args.top, 'part': args.part, 'target_mhz': parse_clock(clock),
+             'filter_length': filter_length, 'data_width': width, 'filter_form': form,
+             'samples_per_clock': samples_per_clock(variant_dir)}
+    if os.path.exists(log_path):
+        with open(log_path) as f:
+            parsed = parse_log(f.read())
+        point.update({k: v for k, v in parsed.items() if v is not None or k not in point})
+    return finish_point(point)
+
+
+def sweep(args):
+    jobs = []
+    for variant in args.variants.split(','):
+        variant_dir = os.path.join(HLS_DIR, variant)
+        # MATCH_FILTER_FORM (0 direct, 1 transposed, 2 systolic) where the variant has it
+        forms = [int(f) for f in args.forms.split(',')] if overridable(variant_dir, 'MATCH_FILTER_FORM') else [None]
+        for clock in args.clocks.split(','):
+            for filter_length in [int(n) for n in args.filter_lengths.split(',')]:
+                for width in [int(n) for n in args.widths.split(',')]:
+                    if ((filter_length != DEFAULT_FILTER_LENGTH and not overridable(variant_dir, 'FILTER_LENGTH')) or
+                            (width != DEFAULT_WIDTH and not overridable(variant_dir, 'DATA_WIDTH'))):
+                        sys.stderr.write('Skipping %s at FILTER_LENGTH %d, DATA_WIDTH %d: sizes are fixed\n' %
+                                         (variant, filter_length, width))
+                        continue
+                    if filter_length < DEFAULT_FILTER_LENGTH and variant not in ('origin', 'resource_opt1'):
+                        sys.stderr.write('Skipping %s at FILTER_LENGTH %d: template has %d taps\n' %
+                                         (variant, filter_length, DEFAULT_FILTER_LENGTH))
+                        continue
+                    for form in forms:
+                        jobs.append((variant, clock, filter_length, width, form))
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        return list(pool.map(lambda job: run_point(args, *job), jobs))
+
+
+def report(args):
+    points = []
+    for log_path in args.logs:
+        variant_dir = os.path.dirname(os.path.abspath(log_path))
+        with open(log_path) as f:
+            point = parse_log(f.read())
+        point['point'] = os.path.relpath(log_path)
+        point['variant'] = os.path.basename(variant_dir)
+        point['samples_per_clock'] = 1
+        if os.path.exists(os.path.join(variant_dir, 'pulseDetector.hpp')):
+            point['samples_per_clock'] = samples_per_clock(variant_dir)
+            point['filter_length'] = header_define(variant_dir, 'FILTER_LENGTH', None)
+            point['data_width'] = header_define(variant_dir, 'DATA_WIDTH', DEFAULT_WIDTH)
+            point['filter_form'] = header_define(variant_dir, 'MATCH_FILTER_FORM', None)
+        points.append(finish_point(point))
+    return points
+
+
+def write_table(points, out):
+    columns = ['variant', 'target_mhz', 'filter_length', 'data_width', 'filter_form', 'achieved_mhz', 'throughput_msps', 'DSP',
+               'LUT', 'FF', 'pareto']
+    rows = [[str(p.get(c, '')) if p.get(c) is not None else '-' for c in columns] for p in points]
+    widths = [max(len(c), *(len(r[i]) for r in rows)) if rows else len(c) for i, c in enumerate(columns)]
+    out.write('  '.join(c.ljust(w) for c, w in zip(columns, widths)) + '\n')
+    for r in rows:
+        out.write('  '.join(v.ljust(w) for v, w in zip(r, widths)) + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest='command')
+    sweep_parser = sub.add_parser('sweep', help='generate and run design points')
+    sweep_parser.add_argument('--variants', default='origin,resource_opt1,resource_opt2,resource_opt3,resource_opt4,resource_opt7')
+    sweep_parser.add_argument('--clocks', default='256MHz,300MHz')
+    sweep_parser.add_argument('--filter-lengths', default=str(DEFAULT_FILTER_LENGTH))
+    sweep_parser.add_argument('--widths', default=str(DEFAULT_WIDTH), help='DATA_WIDTH values (2 integer bits)')
+    sweep_parser.add_argument('--forms', default='0', help='MATCH_FILTER_FORM values: 0 direct, 1 transposed, 2 systolic')
+    sweep_parser.add_argument('--part', default=DEFAULT_PART)
+    sweep_parser.add_argument('--top', default='pulseDetector')
+    sweep_parser.add_argument('--impl', action='store_true', help='also run place and route')
+    sweep_parser.add_argument('--vitis-hls', default='vitis_hls')
+    sweep_parser.add_argument('--build-dir', default='dse_build')
+    sweep_parser.add_argument('-j', '--jobs', type=int, default=1, help='design points run in parallel')
+    sweep_parser.add_argument('--dry-run', action='store_true', help='print the commands, parse existing logs')
+    report_parser = sub.add_parser('report', help='parse existing vitis_hls.log files')
+    report_parser.add_argument('logs', nargs='+')
+    for p in (sweep_parser, report_parser):
+        p.add_argument('--out', help='CSV of every point')
+    args = parser.parse_args()
+
+    if args.command == 'sweep':
+        points = sweep(args)
+    elif args.command == 'report':
+        points = report(args)
+    else:
+        parser.print_help()
+        return 1
+
+    front = pareto(points)
+    if args.out:
+        with open(args.out, 'w', newline='') as f:
+            writer = csv.DictWriter(f, fieldnames=FIELDS, extrasaction='ignore')
+            writer.writeheader()
+            writer.writerows(points)
+
+    sys.stdout.write('All points:\n')
+    write_table(points, sys.stdout)
+    sys.stdout.write('\nPareto front (throughput vs DSP/LUT/FF):\n')
+    write_table(sorted(front, key=lambda p: -p['throughput_msps']), sys.stdout)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
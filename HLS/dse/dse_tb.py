@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Offline check of the DSE log parser and Pareto logic against the checked-in logs."""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import dse
+
+# Figures of the checked-in logs: (impl LUT, FF, DSP), HLS Fmax, post-implementation CP, timing met
+EXPECTED = {
+    'origin': ((2502, 10657, 258), 205.95, None, None),
+    'resource_opt3': ((2261, 7893, 178), 205.95, None, None),
+    'resource_opt4': ((1262, 3836, 53), 205.95, 3.793, True),
+}
+
+
+def main():
+    passed = True
+
+    points = {}
+    for variant in ('origin', 'resource_opt1', 'resource_opt2', 'resource_opt3', 'resource_opt4'):
+        with open(os.path.join(dse.HLS_DIR, variant, 'vitis_hls.log')) as f:
+            point = dse.parse_log(f.read())
+        point['variant'] = variant
+        point['samples_per_clock'] = dse.samples_per_clock(os.path.join(dse.HLS_DIR, variant))
+        points[variant] = dse.finish_point(point)
+        print('%s: %s MHz target, %s MHz achieved, LUT %s FF %s DSP %s (%s)' %
+              (variant, point['target_mhz'], point['achieved_mhz'], point.get('LUT'), point.get('FF'),
+               point.get('DSP'), point['resource_stage']))
+
+    for variant, (resources, fmax, cp_impl, timing_met) in EXPECTED.items():
+        point = points[variant]
+        if (point['LUT'], point['FF'], point['DSP']) != resources or point['resource_stage'] != 'impl':
+            print('%s: resources mismatch' % variant)
+            passed = False
+        if point['hls_fmax_mhz'] != fmax:
+            print('%s: Fmax mismatch' % variant)
+            passed = False
+        if cp_impl is not None and (point['cp_impl_ns'] != cp_impl or point['timing_met'] != timing_met):
+            print('%s: timing mismatch' % variant)
+            passed = False
+    if points['origin']['target_mhz'] != 300.0 or points['resource_opt4']['target_mhz'] != 256.0:
+        print('target clock mismatch')
+        passed = False
+
+    # The FIR IP cores of opt4 take one sample every sample_period = 4 clocks, so
+    # its 256 MHz clock carries 64 MSPS; the others take one sample per clock
+    if points['resource_opt4']['samples_per_clock'] != 0.25 or points['resource_opt4']['throughput_msps'] != 64.0:
+        print('resource_opt4 throughput mismatch: %s MSPS' % points['resource_opt4']['throughput_msps'])
+        passed = False
+    if points['origin']['samples_per_clock'] != 1 or points['resource_opt3']['throughput_msps'] != 286.2:
+        print('throughput mismatch')
+        passed = False
+    if dse.samples_per_clock(os.path.join(dse.HLS_DIR, 'throughput_opt1')) != 4 or \
+            dse.samples_per_clock(os.path.join(dse.HLS_DIR, 'resource_opt6')) != 1:
+        print('samples per clock mismatch')
+        passed = False
+
+    # opt3 and opt4 trade throughput against resources; the rest are dominated by opt3
+    front = dse.pareto(list(points.values()))
+    if sorted(p['variant'] for p in front) != ['resource_opt3', 'resource_opt4']:
+        print('Pareto front mismatch: %s' % [p['variant'] for p in front])
+        passed = False
+
+    # Dominance on hand-made points, including ties and incomplete points
+    a = {'throughput_msps': 300, 'DSP': 50, 'LUT': 1000, 'FF': 2000}
+    b = {'throughput_msps': 300, 'DSP': 50, 'LUT': 1000, 'FF': 2000}
+    c = {'throughput_msps': 250, 'DSP': 60, 'LUT': 1000, 'FF': 2000}
+    d = {'throughput_msps': 600, 'DSP': 100, 'LUT': 900, 'FF': 2000}
+    e = {'throughput_msps': None, 'DSP': 1, 'LUT': 1, 'FF': 1}
+    front = dse.pareto([a, b, c, d, e])
+    if not (a['pareto'] and b['pareto'] and not c['pareto'] and d['pareto'] and not e['pareto']) or len(front) != 3:
+        print('Dominance mismatch')
+        passed = False
+
+    print('Test passed!' if passed else 'Test failed!')
+    return 0 if passed else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,64 @@
+# Usage: vitis_hls -f run_hls_dse.tcl -tclargs <variant dir> <clock> <part> <top> <impl> [cflags]
+# One design point of the DSE sweep (dse.py). Run from the point directory:
+# the project is created there and the sources are taken from <variant dir>.
+# <impl> 0 runs csynth and Vivado synthesis, 1 also runs implementation.
+# cflags carry the sizing overrides, e.g. "-DFILTER_LENGTH=96 -DDATA_WIDTH=16"
+
+if {[llength $argv] < 5} {
+  puts "Usage: vitis_hls -f run_hls_dse.tcl -tclargs <variant dir> <clock> <part> <top> <impl> \[cflags\]"
+  exit 1
+}
+set SRCDIR [file normalize [lindex $argv 0]]
+set CLKP [lindex $argv 1]
+set XPART [lindex $argv 2]
+set TOP [lindex $argv 3]
+set VIVADO_IMPL [lindex $argv 4]
+set CFLAGS [lrange $argv 5 end]
+
+# select what needs to run
+set CSIM 0
+set CSYNTH 1
+set COSIM 0
+set VIVADO_SYN 1
+set SOLN "solution1"
+
+puts "DSE point: ${SRCDIR} ${CLKP} ${XPART} ${TOP} ${CFLAGS}"
+
+set basename "pulseDetector"
+
+open_project -reset proj_${basename}
+set_top ${TOP}
+
+add_files ${SRCDIR}/${basename}.cpp -cflags "${CFLAGS}"
+
+add_files -tb ${SRCDIR}/${basename}_tb.cpp -cflags "${CFLAGS}"
+foreach f {RxSignal_in.txt CorrFilter_in.txt peak_out.txt location_out.txt} {
+  if {[file exists ${SRCDIR}/${f}]} {
+    add_files -tb ${SRCDIR}/${f}
+  }
+}
+
+open_solution -reset ${SOLN}
+set_part $XPART
+create_clock -period $CLKP
+set_clock_uncertainty 12.5%
+
+config_rtl -reset control
+
+if {$CSIM == 1} {
+  csim_design
+}
+if {$CSYNTH == 1} {
+  csynth_design
+}
+if {$COSIM == 1} {
+  cosim_design
+}
+if {$VIVADO_SYN == 1} {
+  export_design -flow syn -rtl verilog
+}
+if {$VIVADO_IMPL == 1} {
+  export_design -flow impl -rtl verilog -format syn_dcp
+}
+
+exit
@@ -0,0 +1,210 @@
+#include "batchReplay.hpp"
+#include "workStealingPool.hpp"
+#include "../common/iqCapture.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+namespace detector {
+namespace model {
+
+bool loadTextCapture(const std::string& path, std::vector<int32_t>& re, std::vector<int32_t>& im) {
+    std::ifstream file(path.c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+
+    re.clear();
+    im.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        // strtod instead of stringstream, the parse dominates large captures
+        const char* p = line.c_str();
+        char* end;
+        double real_part = std::strtod(p, &end);
+        if (end == p) {
+            continue;
+        }
+        p = end;
+        double imag_part = std::strtod(p, &end);
+        if (end == p) {
+            continue;
+        }
+        re.push_back(toFixed(real_part));
+        im.push_back(toFixed(imag_part));
+    }
+    return true;
+}
+
+static bool isDirectory(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+batch_replay::batch_replay(const double (*taps_in)[3], int num_taps, model_arch arch, int frame_length, int num_workers)
+    : taps(taps_in[0], taps_in[0] + 3 * num_taps), num_taps(num_taps), arch(arch), frame_length(frame_length), num_workers(num_workers) {
+}
+
+void batch_replay::addPath(const std::string& path) {
+    if (!path.empty() && path[0] == '@') {
+        std::ifstream list(path.c_str() + 1);
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line[0] != '#') {
+                addPath(line);
+            }
+        }
+        return;
+    }
+
+    if (!isDirectory(path)) {
+        paths.push_back(path);
+        return;
+    }
+
+    std::vector<std::string> entries;
+    DIR* dir = opendir(path.c_str());
+    if (dir == NULL) {
+        return;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        std::string full = path + "/" + name;
+        struct stat st;
+        if (name[0] != '.' && stat(full.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            entries.push_back(full);
+        }
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    paths.insert(paths.end(), entries.begin(), entries.end());
+}
+
+replay_stats batch_replay::run() {
+    // A binary capture is mapped and read in place (interleaved, stride 2); a
+    // text capture is parsed into planar vectors
+    struct capture_data {
+        iq_capture map;
+        std::vector<int32_t> re_words;
+        std::vector<int32_t> im_words;
+        const int32_t* re;
+        const int32_t* im;
+        int stride;
+        size_t samples;
+    };
+
+    const int num_captures = (int)paths.size();
+    frame_results.assign(num_captures, std::vector<frame_result>());
+
+    // One detector per worker, created on the worker's first frame
+    std::vector<std::unique_ptr<pulse_detector_model> > detectors(num_workers);
+    const double (*tap_rows)[3] = reinterpret_cast<const double (*)[3]>(taps.data());
+
+    std::atomic<long> frames(0), samples(0), dropped(0), failed(0);
+    replay_stats stats;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        work_stealing_pool pool(num_workers);
+
+        for (int c = 0; c < num_captures; c++) {
+            pool.submit([&, c](int w) {
+                std::shared_ptr<capture_data> data(new capture_data);
+                int length = frame_length;
+                if (isIqCapture(paths[c])) {
+                    if (!data->map.open(paths[c])) {
+                        std::cerr << "Error opening " << paths[c] << std::endl;
+                        failed++;
+                        return;
+                    }
+                    data->re = data->map.data();
+                    data->im = data->map.data() + 1;
+                    data->stride = 2;
+                    data->samples = data->map.numSamples();
+                    if (length <= 0) {
+                        length = data->map.frameLength();
+                    }
+                } else {
+                    if (!loadTextCapture(paths[c], data->re_words, data->im_words)) {
+                        std::cerr << "Error opening " << paths[c] << std::endl;
+                        failed++;
+                        return;
+                    }
+                    data->re = data->re_words.data();
+                    data->im = data->im_words.data();
+                    data->stride = 1;
+                    data->samples = data->re_words.size();
+                }
+                if (length <= 0) {
+                    std::cerr << "No frame length for " << paths[c] << std::endl;
+                    failed++;
+                    return;
+                }
+
+                int num_frames = (int)(data->samples / length);
+                dropped += (long)(data->samples - (size_t)num_frames * length);
+                frame_results[c].resize(num_frames);
+
+                for (int f = 0; f < num_frames; f++) {
+                    pool.submitLocal(w, [&, c, f, length, data](int fw) {
+                        if (!detectors[fw]) {
+                            detectors[fw].reset(new pulse_detector_model(tap_rows, num_taps, arch));
+                        }
+                        frame_result& r = frame_results[c][f];
+                        r.capture = c;
+                        r.frame = f;
+                        size_t first = (size_t)f * length * data->stride;
+                        detectors[fw]->pulseDetector(data->re + first, data->im + first, length, r.peak, r.location,
+                                                     data->stride);
+                        frames++;
+                        samples += length;
+                    });
+                }
+            });
+        }
+        pool.wait();
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        for (int w = 0; w < num_workers; w++) {
+            stats.tasks_per_worker.push_back(pool.taskCount(w));
+            stats.steals_per_worker.push_back(pool.stealCount(w));
+        }
+    }
+
+    stats.captures = num_captures;
+    stats.frames = frames;
+    stats.samples = samples;
+    stats.dropped_samples = dropped;
+    stats.failed_captures = failed;
+    return stats;
+}
+
+void batch_replay::writeResults(std::ostream& out) const {
+    out << "capture,frame,peak,location" << std::endl;
+    for (size_t c = 0; c < frame_results.size(); c++) {
+        for (size_t f = 0; f < frame_results[c].size(); f++) {
+            const frame_result& r = frame_results[c][f];
+            out << paths[c] << "," << r.frame << "," << fromFixed(r.peak) << "," << r.location << std::endl;
+        }
+    }
+}
+
+void batch_replay::writeStats(std::ostream& out, const replay_stats& stats) {
+    out << "captures: " << stats.captures << " (" << stats.failed_captures << " failed to load)" << std::endl;
+    out << "frames: " << stats.frames << std::endl;
+    out << "samples: " << stats.samples << " (" << stats.dropped_samples << " dropped in partial frames)" << std::endl;
+    out << "seconds: " << stats.seconds << std::endl;
+    out << "frames/s: " << stats.frames / stats.seconds << std::endl;
+    out << "MSPS: " << stats.samples / stats.seconds / 1e6 << std::endl;
+    for (size_t w = 0; w < stats.tasks_per_worker.size(); w++) {
+        out << "worker " << w << ": tasks " << stats.tasks_per_worker[w] << ", steals " << stats.steals_per_worker[w] << std::endl;
+    }
+}
+
+} // namespace model
+} // namespace detector
@@ -0,0 +1,73 @@
+#ifndef BATCH_REPLAY_HPP
+#define BATCH_REPLAY_HPP
+
+#include "pulseDetectorModel.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace detector {
+namespace model {
+
+// Detection of one frame of one capture
+struct frame_result {
+    int capture;
+    int frame;
+    int32_t peak;
+    int location;
+};
+
+struct replay_stats {
+    long captures;
+    long frames;
+    long samples;
+    long dropped_samples; // tail of a capture shorter than one frame
+    long failed_captures; // could not be opened, or no frame length
+    double seconds;
+    std::vector<long> tasks_per_worker; // capture loads and frames
+    std::vector<long> steals_per_worker;
+};
+
+// Replays capture files frame by frame through the host model on a
+// work-stealing pool. Each capture is loaded by one task, which spawns one
+// task per frame onto its own worker; every worker owns a detector instance,
+// so no state is shared between frames in flight. Binary captures
+// (iqCapture.hpp) are mapped and read in place, anything else is parsed as
+// text. A frame_length of 0 takes the frame length from each binary
+// capture's header.
+class batch_replay {
+public:
+    batch_replay(const double (*taps)[3], int num_taps, model_arch arch, int frame_length, int num_workers);
+
+    // A capture file, a directory (all regular files in it, sorted) or
+    // @list, a text file with one path per line
+    void addPath(const std::string& path);
+    const std::vector<std::string>& captures() const { return paths; }
+
+    // Captures that fail to load are reported on stderr and counted in
+    // failed_captures; their result lists stay empty
+    replay_stats run();
+
+    // Results in capture, frame order, valid after run()
+    const std::vector<std::vector<frame_result> >& results() const { return frame_results; }
+    void writeResults(std::ostream& out) const;
+    static void writeStats(std::ostream& out, const replay_stats& stats);
+
+private:
+    std::vector<double> taps;
+    int num_taps;
+    model_arch arch;
+    int frame_length;
+    int num_workers;
+
+    std::vector<std::string> paths;
+    std::vector<std::vector<frame_result> > frame_results;
+};
+
+// Text capture as exported from MATLAB: one "re im" pair per line
+bool loadTextCapture(const std::string& path, std::vector<int32_t>& re, std::vector<int32_t>& im);
+
+} // namespace model
+} // namespace detector
+
+#endif
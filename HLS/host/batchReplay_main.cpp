@@ -0,0 +1,81 @@
+#include "batchReplay.hpp"
+#include "templateTaps.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace detector::model;
+
+static void usage(const char* name) {
+    cerr << "Usage: " << name << " [-j threads] [-a three-real|fir-ip] [-f frame_length, default from .iq header] [-o results.csv] capture|dir|@list ..." << endl;
+}
+
+int main(int argc, char** argv) {
+    int num_workers = (int)thread::hardware_concurrency();
+    model_arch arch = ARCH_THREE_REAL;
+    int frame_length = 0; // from the capture header
+    const char* out_path = NULL;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "-j") == 0) {
+            num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0) {
+            frame_length = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-a") == 0) {
+            i++;
+            if (strcmp(argv[i], "three-real") == 0) {
+                arch = ARCH_THREE_REAL;
+            } else if (strcmp(argv[i], "fir-ip") == 0) {
+                arch = ARCH_FIR_IP;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (i == argc || num_workers < 1 || frame_length < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    double fir_taps[TEMPLATE_TAPS][3];
+    firTaps(0, fir_taps);
+
+    batch_replay replay(arch == ARCH_THREE_REAL ? threeRealTaps : fir_taps, TEMPLATE_TAPS, arch, frame_length, num_workers);
+    for (; i < argc; i++) {
+        replay.addPath(argv[i]);
+    }
+
+    replay_stats stats = replay.run();
+
+    if (out_path != NULL) {
+        ofstream out_file(out_path);
+        if (!out_file.is_open()) {
+            cerr << "Error opening " << out_path << endl;
+            return 1;
+        }
+        replay.writeResults(out_file);
+    } else {
+        replay.writeResults(cout);
+    }
+
+    cerr << "threads: " << num_workers << ", isa: " << isaName(bestIsa()) << endl;
+    batch_replay::writeStats(cerr, stats);
+
+    // Results are still written for the captures that loaded, but a missing
+    // or unreadable capture fails the run
+    return stats.failed_captures != 0 ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+#include "batchReplay.hpp"
+#include "templateTaps.hpp"
+#include "../common/iqCapture.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace detector::model;
+
+#define SIGNAL_LENGTH 5000
+
+// Captures replayed per run, alternately text and binary; each is the
+// reference signal repeated FRAMES times
+#define CAPTURES 12
+#define FRAMES 4
+
+int main() {
+    vector<int32_t> rx_re, rx_im;
+    int location_ref;
+    bool passed = true;
+
+    if (!loadTextCapture("../resource_opt3/RxSignal_in.txt", rx_re, rx_im) || (int)rx_re.size() < SIGNAL_LENGTH) {
+        cerr << "Error opening RxSignal_in.txt" << endl;
+        return 1;
+    }
+
+    ifstream location_file("../resource_opt3/location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Capture archive: the reference frame repeated, plus a partial frame at the end
+    string capture_path = "batchReplay_capture.txt";
+    ofstream capture_file(capture_path.c_str());
+    capture_file.precision(17);
+    for (int f = 0; f < FRAMES; f++) {
+        for (int n = 0; n < SIGNAL_LENGTH; n++) {
+            capture_file << fromFixed(rx_re[n]) << " " << fromFixed(rx_im[n]) << "\n";
+        }
+    }
+    for (int n = 0; n < SIGNAL_LENGTH / 2; n++) {
+        capture_file << fromFixed(rx_re[n]) << " " << fromFixed(rx_im[n]) << "\n";
+    }
+    capture_file.close();
+
+    // The same archive as a binary capture; the replay mixes both formats
+    string iq_path = "batchReplay_capture.iq";
+    if (!detector::convertTextCapture(capture_path, iq_path, SIGNAL_LENGTH, 0)) {
+        cerr << "Error converting " << capture_path << endl;
+        return 1;
+    }
+
+    double fir_taps[TEMPLATE_TAPS][3];
+    firTaps(0, fir_taps);
+
+    const model_arch archs[2] = {ARCH_THREE_REAL, ARCH_FIR_IP};
+    const char* archNames[2] = {"three-real", "fir-ip"};
+    const int workers[3] = {1, 4, 16};
+
+    for (int a = 0; a < 2; a++) {
+        const double (*taps)[3] = archs[a] == ARCH_THREE_REAL ? threeRealTaps : fir_taps;
+
+        // Single-threaded model on one frame is the expected result of every frame
+        pulse_detector_model model(taps, TEMPLATE_TAPS, archs[a]);
+        int32_t peak_ref;
+        int location_model;
+        model.pulseDetector(&rx_re[0], &rx_im[0], SIGNAL_LENGTH, peak_ref, location_model);
+
+        for (int w = 0; w < 3; w++) {
+            batch_replay replay(taps, TEMPLATE_TAPS, archs[a], SIGNAL_LENGTH, workers[w]);
+            for (int c = 0; c < CAPTURES; c++) {
+                replay.addPath(c % 2 == 0 ? capture_path : iq_path);
+            }
+            replay_stats stats = replay.run();
+
+            int mismatches = 0;
+            for (size_t c = 0; c < replay.results().size(); c++) {
+                if (replay.results()[c].size() != FRAMES) {
+                    mismatches++;
+                    continue;
+                }
+                for (int f = 0; f < FRAMES; f++) {
+                    const frame_result& r = replay.results()[c][f];
+                    if (r.capture != (int)c || r.frame != f || r.peak != peak_ref || r.location + 1 != location_ref) {
+                        mismatches++;
+                    }
+                }
+            }
+
+            cout << "Replay " << archNames[a] << " x" << workers[w] << ": Frames: " << stats.frames
+                 << ", Dropped samples: " << stats.dropped_samples << ", Mismatches: " << mismatches
+                 << ", MSPS: " << stats.samples / stats.seconds / 1e6 << endl;
+
+            if (mismatches != 0 || stats.frames != CAPTURES * FRAMES || stats.dropped_samples != CAPTURES * (SIGNAL_LENGTH / 2)) {
+                passed = false;
+            }
+        }
+    }
+
+    // A missing capture is counted as failed; the others still replay
+    batch_replay partial(threeRealTaps, TEMPLATE_TAPS, ARCH_THREE_REAL, SIGNAL_LENGTH, 4);
+    partial.addPath(capture_path);
+    partial.addPath("batchReplay_missing.txt");
+    partial.addPath(iq_path);
+    replay_stats partial_stats = partial.run();
+    cout << "Replay with a missing capture: Failed: " << partial_stats.failed_captures << ", Frames: " << partial_stats.frames
+         << endl;
+    if (partial_stats.failed_captures != 1 || partial_stats.frames != 2 * FRAMES || !partial.results()[1].empty() ||
+        partial.results()[2].size() != FRAMES) {
+        passed = false;
+    }
+
+    remove(capture_path.c_str());
+    remove(iq_path.c_str());
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
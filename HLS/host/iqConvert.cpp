@@ -0,0 +1,41 @@
+#include "../common/iqCapture.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// One-off conversion of MATLAB text exports to binary IQ captures
+int main(int argc, char** argv) {
+    unsigned frame_length = 0;
+    double sample_rate = 0;
+    int i;
+
+    for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (strcmp(argv[i], "-f") == 0) {
+            frame_length = (unsigned)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            sample_rate = atof(argv[i + 1]);
+        } else {
+            break;
+        }
+    }
+    if (argc - i != 2) {
+        cerr << "Usage: " << argv[0] << " [-f frame_length] [-r sample_rate_hz] capture.txt capture.iq" << endl;
+        return 1;
+    }
+
+    if (!detector::convertTextCapture(argv[i], argv[i + 1], frame_length, sample_rate)) {
+        cerr << "Error converting " << argv[i] << " to " << argv[i + 1] << endl;
+        return 1;
+    }
+
+    detector::iq_capture capture;
+    if (!capture.open(argv[i + 1])) {
+        cerr << "Error opening " << argv[i + 1] << endl;
+        return 1;
+    }
+    cout << argv[i + 1] << ": " << capture.numSamples() << " samples, frame " << capture.frameLength()
+         << ", " << capture.sampleRate() << " Hz" << endl;
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include "perfModel.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <sstream>
+
+namespace detector {
+namespace model {
+
+// A token on a stream: the frame it belongs to and whether it is the frame's
+// last one
+struct token {
+    int frame;
+    bool last;
+};
+
+struct in_flight {
+    token t;
+    int age;
+    bool emits;
+};
+
+enum process_phase {
+    PHASE_SETUP, // call overhead and prologue
+    PHASE_RUN,
+    PHASE_DRAIN
+};
+
+struct process_state {
+    std::deque<in_flight> pipeline;
+    process_phase phase;
+    int setup_left;
+    int iteration;
+    long next_issue;
+};
+
+perf_config defaultPerfConfig() {
+    perf_config c;
+    c.frame_length = 5000;
+    c.frames = 8;
+    c.input_period = 1;
+    c.input_depth = 2;
+    c.call_overhead = 1;
+    c.clock_mhz = 300;
+    return c;
+}
+
+double perf_result::interval() const {
+    // The first frames include the pipeline fill, so the interval is taken
+    // over the second half
+    int n = (int)frames.size();
+    if (n < 2) {
+        return n == 1 ? (double)frames[0].latency() : 0;
+    }
+    int first = n / 2 < n - 1 ? n / 2 : n - 2;
+    return (double)(frames[n - 1].done - frames[first].done) / (n - 1 - first);
+}
+
+int perf_result::bottleneck(const std::vector<process_spec>& chain) const {
+    int worst = 0;
+    double worst_busy = -1;
+    for (size_t p = 0; p < chain.size(); p++) {
+        double busy = (double)processes[p].iterations * chain[p].ii;
+        if (busy > worst_busy) {
+            worst_busy = busy;
+            worst = (int)p;
+        }
+    }
+    return worst;
+}
+
+dataflow_model::dataflow_model(const std::vector<process_spec>& chain, const perf_config& config) : processes(chain), cfg(config) {}
+
+perf_result dataflow_model::run() const {
+    const int num = (int)processes.size();
+    perf_result r;
+    r.frames.assign(cfg.frames, frame_timing());
+    r.processes.assign(num, process_stats());
+    r.input_blocked = 0;
+    r.completed = false;
+
+    // fifos[p] is the input of process p; fifos[0] the input stream
+    std::vector<std::deque<token> > fifos(num);
+    std::vector<int> capacity(num);
+    capacity[0] = cfg.input_depth;
+    for (int p = 1; p < num; p++) {
+        capacity[p] = processes[p - 1].fifo_depth;
+    }
+
+    std::vector<process_state> state(num);
+    for (int p = 0; p < num; p++) {
+        state[p].phase = PHASE_SETUP;
+        state[p].setup_left = cfg.call_overhead + processes[p].prologue;
+        state[p].iteration = 0;
+        state[p].next_issue = 0;
+    }
+
+    const long total_samples = (long)cfg.frame_length * cfg.frames;
+    long samples_in = 0;
+    long next_sample = 0;
+    int frames_done = 0;
+    long limit = (total_samples + 1000) * (long)cfg.input_period * 64 + 1000000;
+    for (int p = 0; p < num; p++) {
+        limit += total_samples * (long)processes[p].ii;
+    }
+
+    long t = 0;
+    for (; t < limit && frames_done < cfg.frames; t++) {
+        // Downstream first: a slot freed this cycle can be filled by the
+        // producer in the same cycle, and a token written this cycle is read
+        // on the next one
+        for (int p = num - 1; p >= 0; p--) {
+            const process_spec& spec = processes[p];
+            process_state& s = state[p];
+            process_stats& stats = r.processes[p];
+            std::deque<token>* out = p + 1 < num ? &fifos[p + 1] : NULL;
+
+            bool blocked = false;
+            if (!s.pipeline.empty() && s.pipeline.front().age >= spec.depth) {
+                const in_flight& head = s.pipeline.front();
+                if (head.emits) {
+                    if (out != NULL && (int)out->size() >= capacity[p + 1]) {
+                        blocked = true;
+                    } else if (out != NULL) {
+                        out->push_back(head.t);
+                    } else if (head.t.last) {
+                        r.frames[head.t.frame].done = t;
+                        frames_done++;
+                    }
+                }
+                if (!blocked) {
+                    s.pipeline.pop_front();
+                }
+            }
+            if (out != NULL) {
+                int fill = (int)out->size();
+                if (fill > stats.max_fill) {
+                    stats.max_fill = fill;
+                }
+                if (fill >= capacity[p + 1]) {
+                    stats.full++;
+                }
+            }
+            if (blocked) {
+                stats.blocked++;
+                continue;
+            }
+            for (size_t k = 0; k < s.pipeline.size(); k++) {
+                s.pipeline[k].age++;
+            }
+
+            if (s.phase == PHASE_DRAIN && s.pipeline.empty()) {
+                s.phase = PHASE_SETUP;
+                s.setup_left = cfg.call_overhead + spec.prologue;
+            }
+            if (s.phase == PHASE_SETUP) {
+                if (s.setup_left > 0) {
+                    s.setup_left--;
+                    continue;
+                }
+                s.phase = PHASE_RUN;
+            }
+            if (s.phase != PHASE_RUN || t < s.next_issue) {
+                continue;
+            }
+            if (fifos[p].empty()) {
+                stats.starved++;
+                continue;
+            }
+
+            token in = fifos[p].front();
+            fifos[p].pop_front();
+            if (p == 0 && s.iteration == 0) {
+                r.frames[in.frame].first_in = t;
+            }
+            in_flight f;
+            f.t = in;
+            f.age = 1; // aged from the next cycle on, written depth cycles after the read
+            f.emits = !spec.reduce || in.last;
+            s.pipeline.push_back(f);
+            stats.iterations++;
+            s.next_issue = t + spec.ii;
+            if (++s.iteration == cfg.frame_length) {
+                s.iteration = 0;
+                if (spec.drain) {
+                    s.phase = PHASE_DRAIN;
+                } else if (spec.prologue > 0) {
+                    s.phase = PHASE_SETUP;
+                    s.setup_left = spec.prologue;
+                }
+            }
+        }
+
+        // Input stream, one sample every input_period cycles
+        if (samples_in < total_samples && t >= next_sample) {
+            if ((int)fifos[0].size() < capacity[0]) {
+                token in;
+                in.frame = (int)(samples_in / cfg.frame_length);
+                in.last = samples_in % cfg.frame_length == cfg.frame_length - 1;
+                fifos[0].push_back(in);
+                samples_in++;
+                next_sample = t + cfg.input_period;
+            } else {
+                r.input_blocked++;
+            }
+        }
+    }
+
+    r.cycles = t;
+    r.completed = frames_done == cfg.frames;
+    return r;
+}
+
+void dataflow_model::report(const perf_result& r, std::ostream& out) const {
+    char line[160];
+    const double ns_per_cycle = 1000.0 / cfg.clock_mhz;
+    if (!r.completed) {
+        out << "Stopped after " << r.cycles << " cycles with frames outstanding" << std::endl;
+        return;
+    }
+
+    out << "Frames: " << cfg.frames << " x " << cfg.frame_length << " samples, one every " << cfg.input_period
+        << " cycles, clock " << cfg.clock_mhz << " MHz" << std::endl;
+    std::snprintf(line, sizeof(line), "%5s %10s %10s %14s %14s", "frame", "first in", "done", "latency (cyc)", "latency (us)");
+    out << line << std::endl;
+    for (size_t f = 0; f < r.frames.size(); f++) {
+        const frame_timing& ft = r.frames[f];
+        std::snprintf(line, sizeof(line), "%5d %10ld %10ld %14ld %14.3f", (int)f, ft.first_in, ft.done, ft.latency(),
+                      ft.latency() * ns_per_cycle / 1000);
+        out << line << std::endl;
+    }
+
+    double interval = r.interval();
+    double samples_per_cycle = interval > 0 ? cfg.frame_length / interval : 0;
+    std::snprintf(line, sizeof(line), "Frame interval: %.1f cycles (%.3f us), %.4f samples/cycle, %.2f MSPS, %.1f frames/s",
+                  interval, interval * ns_per_cycle / 1000, samples_per_cycle, samples_per_cycle * cfg.clock_mhz,
+                  interval > 0 ? 1e9 / (interval * ns_per_cycle) : 0);
+    out << line << std::endl;
+
+    std::snprintf(line, sizeof(line), "%-14s %4s %6s %9s %10s %10s %9s %8s", "process", "ii", "depth", "busy", "starved",
+                  "blocked", "fifo max", "full");
+    out << line << std::endl;
+    for (size_t p = 0; p < processes.size(); p++) {
+        const process_spec& spec = processes[p];
+        const process_stats& s = r.processes[p];
+        char fifo[16];
+        if (p + 1 < processes.size()) {
+            std::snprintf(fifo, sizeof(fifo), "%d/%d", s.max_fill, spec.fifo_depth);
+        } else {
+            std::snprintf(fifo, sizeof(fifo), "sink");
+        }
+        std::snprintf(line, sizeof(line), "%-14s %4d %6d %8.1f%% %10ld %10ld %9s %8ld", spec.name.c_str(), spec.ii, spec.depth,
+                      100.0 * s.iterations * spec.ii / r.cycles, s.starved, s.blocked, fifo, s.full);
+        out << line << std::endl;
+    }
+    out << "Input stream blocked: " << r.input_blocked << " cycles; bottleneck: " << processes[r.bottleneck(processes)].name
+        << std::endl;
+}
+
+bool variantChain(const std::string& variant, int taps, std::vector<process_spec>& chain) {
+    // name, ii, depth, fifo_depth, prologue, reduce, drain
+    const process_spec peak_finder = {"peakFinder", 1, 3, 0, 0, true, true};
+    chain.clear();
+    if (variant == "origin") {
+        // The correlator loop has depth 21 and is preceded by the 64-tap
+        // coefficient load (depth 2) on every call
+        process_spec filter = {"matchFilter", 1, 21 * taps / 64, 4, taps + 2, false, true};
+        chain.push_back(filter);
+        chain.push_back(peak_finder);
+    } else if (variant == "resource_opt2" || variant == "resource_opt3") {
+        // Direct-form adder chain over the delay line: depth 79 (complex) and
+        // 137 (three real filters) at 64 taps
+        int depth = variant == "resource_opt2" ? 79 : 137;
+        process_spec filter = {"matchFilter", 1, 9 + (depth - 9) * taps / 64, 4, 0, false, true};
+        chain.push_back(filter);
+        chain.push_back(peak_finder);
+    } else if (variant == "resource_opt4") {
+        // Rewound front and back ends around the FIR IP cores, which take one
+        // sample every sample_period = 4 cycles. The three cores run in
+        // lockstep and are modelled as one.
+        process_spec fe = {"process_fe", 1, 3, 2, 0, false, false};
+        process_spec fir = {"fir", 4, 6, 2, 0, false, false};
+        process_spec be = {"process_be", 1, 7, 4, 0, false, false};
+        chain.push_back(fe);
+        chain.push_back(fir);
+        chain.push_back(be);
+        chain.push_back(peak_finder);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseProcess(const std::string& text, process_spec& p) {
+    std::stringstream ss(text);
+    std::string field;
+    std::vector<std::string> fields;
+    while (std::getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 4 || fields.size() > 6 || fields[0].empty()) {
+        return false;
+    }
+    p.name = fields[0];
+    p.ii = std::atoi(fields[1].c_str());
+    p.depth = std::atoi(fields[2].c_str());
+    p.fifo_depth = std::atoi(fields[3].c_str());
+    p.prologue = fields.size() > 4 ? std::atoi(fields[4].c_str()) : 0;
+    p.reduce = false;
+    p.drain = false;
+    if (fields.size() > 5) {
+        for (size_t k = 0; k < fields[5].size(); k++) {
+            if (fields[5][k] == 'r') {
+                p.reduce = true;
+            } else if (fields[5][k] == 'd') {
+                p.drain = true;
+            } else {
+                return false;
+            }
+        }
+    }
+    return p.ii >= 1 && p.depth >= 1 && p.fifo_depth >= 0 && p.prologue >= 0;
+}
+
+} // namespace model
+} // namespace detector
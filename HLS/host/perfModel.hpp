@@ -0,0 +1,103 @@
+#ifndef PERF_MODEL_HPP
+#define PERF_MODEL_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Cycle-level performance model of a detector DATAFLOW region: a chain of
+// pipelined processes joined by FIFOs, e.g. process_fe, the FIR IP cores,
+// process_be and peakFinder of resource_opt4. Each process issues one loop
+// iteration every ii cycles when its input FIFO has a token, and writes the
+// result depth cycles later. A pipeline whose result finds its output FIFO
+// full stalls as a whole, as an HLS pipeline does. The model runs any number
+// of frames back to back and reports per-frame latency, the frame interval
+// in steady state and where the processes starved or blocked, in seconds at
+// a given clock, without csynth or cosim.
+namespace detector {
+namespace model {
+
+struct process_spec {
+    std::string name;
+    int ii;          // cycles between iterations
+    int depth;       // pipeline depth, cycles from read to write (>= 1)
+    int fifo_depth;  // of the stream to the next process; the last one feeds the sink
+    int prologue;    // cycles of per-frame setup before the first iteration
+    bool reduce;     // one output per frame, on its last iteration (peakFinder)
+    bool drain;      // not rewound: the pipeline drains before the next frame starts
+};
+
+struct perf_config {
+    int frame_length;
+    int frames;
+    int input_period;  // cycles between input samples, 1 back to back
+    int input_depth;   // of the input stream
+    int call_overhead; // cycles to restart a process between frames (ap_ctrl handshake)
+    double clock_mhz;
+};
+
+// Frame f: the first sample read by the first process and the last output
+// written by the last one, in cycles from 0
+struct frame_timing {
+    long first_in;
+    long done;
+
+    long latency() const { return done - first_in + 1; }
+};
+
+struct process_stats {
+    long iterations;
+    long starved;   // cycles ready to issue with an empty input
+    long blocked;   // cycles stalled on a full output
+    int max_fill;   // largest occupancy of the output FIFO
+    long full;      // cycles the output FIFO was full
+};
+
+struct perf_result {
+    std::vector<frame_timing> frames;
+    std::vector<process_stats> processes;
+    long input_blocked; // cycles the input had a sample but the stream was full
+    long cycles;
+    bool completed;     // false if the cycle limit was hit
+
+    // Cycles between frame completions in steady state (the last frames)
+    double interval() const;
+    // Process whose issue slots are busiest, the throughput limit
+    int bottleneck(const std::vector<process_spec>& chain) const;
+};
+
+class dataflow_model {
+public:
+    dataflow_model(const std::vector<process_spec>& chain, const perf_config& config);
+
+    perf_result run() const;
+
+    // Per-frame latency, interval, throughput and stalls; the seconds and
+    // MSPS figures use config.clock_mhz
+    void report(const perf_result& r, std::ostream& out) const;
+
+    const std::vector<process_spec>& chain() const { return processes; }
+    const perf_config& config() const { return cfg; }
+
+private:
+    std::vector<process_spec> processes;
+    perf_config cfg;
+};
+
+perf_config defaultPerfConfig();
+
+// Process chain of a checked-in variant at 64 taps, with the loop depths of
+// its vitis_hls.log: origin, resource_opt2, resource_opt3 or resource_opt4.
+// For other filter lengths the correlator depth of the direct forms is scaled
+// with the adder chain, an estimate to screen candidates, not a synthesis
+// result. False for an unknown variant.
+bool variantChain(const std::string& variant, int taps, std::vector<process_spec>& chain);
+
+// "name,ii,depth,fifo_depth[,prologue[,flags]]", flags r (reduce) and d (drain)
+// fifo_depth 0 is accepted for the sink; the caller checks the other processes
+bool parseProcess(const std::string& text, process_spec& p);
+
+} // namespace model
+} // namespace detector
+
+#endif
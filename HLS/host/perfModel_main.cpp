@@ -0,0 +1,85 @@
+#include "perfModel.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using namespace detector::model;
+
+static void usage(const char* name) {
+    cerr << "Usage: " << name << " [-v variant, default resource_opt3] [-t taps, default 64] [-n frame_length, default 5000]"
+         << " [-f frames, default 8] [-c clock_mhz, default 300] [-i input_period, default 1] [-d input_depth, default 2]"
+         << " [-o call_overhead, default 1] [-s name,ii,depth,fifo_depth[,prologue[,flags]]] ..." << endl;
+    cerr << "Variants: origin, resource_opt2, resource_opt3, resource_opt4; -s replaces the variant chain," << endl;
+    cerr << "one process per -s in order, flags r (one output per frame) and d (drains between frames)" << endl;
+}
+
+int main(int argc, char** argv) {
+    perf_config cfg = defaultPerfConfig();
+    string variant = "resource_opt3";
+    int taps = 64;
+    vector<process_spec> custom;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-' || i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* opt = argv[i];
+        const char* arg = argv[++i];
+        if (strcmp(opt, "-v") == 0) {
+            variant = arg;
+        } else if (strcmp(opt, "-t") == 0) {
+            taps = atoi(arg);
+        } else if (strcmp(opt, "-n") == 0) {
+            cfg.frame_length = atoi(arg);
+        } else if (strcmp(opt, "-f") == 0) {
+            cfg.frames = atoi(arg);
+        } else if (strcmp(opt, "-c") == 0) {
+            cfg.clock_mhz = atof(arg);
+        } else if (strcmp(opt, "-i") == 0) {
+            cfg.input_period = atoi(arg);
+        } else if (strcmp(opt, "-d") == 0) {
+            cfg.input_depth = atoi(arg);
+        } else if (strcmp(opt, "-o") == 0) {
+            cfg.call_overhead = atoi(arg);
+        } else if (strcmp(opt, "-s") == 0) {
+            process_spec p;
+            if (!parseProcess(arg, p)) {
+                cerr << "Bad process " << arg << endl;
+                return 1;
+            }
+            custom.push_back(p);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (taps < 1 || cfg.frame_length < 1 || cfg.frames < 1 || cfg.clock_mhz <= 0 || cfg.input_period < 1 ||
+        cfg.input_depth < 1 || cfg.call_overhead < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    for (size_t p = 0; p + 1 < custom.size(); p++) {
+        if (custom[p].fifo_depth < 1) {
+            cerr << "Process " << custom[p].name << " needs a fifo depth of at least 1; only the last may use 0" << endl;
+            return 1;
+        }
+    }
+
+    vector<process_spec> chain = custom;
+    if (chain.empty()) {
+        if (!variantChain(variant, taps, chain)) {
+            cerr << "Unknown variant " << variant << endl;
+            usage(argv[0]);
+            return 1;
+        }
+        cout << variant << ", " << taps << " taps" << endl;
+    }
+
+    dataflow_model model(chain, cfg);
+    perf_result r = model.run();
+    model.report(r, cout);
+    return r.completed ? 0 : 1;
+}
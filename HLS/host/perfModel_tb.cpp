@@ -0,0 +1,119 @@
+#include "perfModel.hpp"
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace detector::model;
+
+#define SIGNAL_LENGTH 5000
+
+// Cycles of one 5000-sample frame in the checked-in cosim reports
+// (vitis_hls.log, RTL simulation time over the clock period)
+struct cosim_point {
+    const char* variant;
+    long cycles;
+};
+
+static const cosim_point cosim[] = {
+    {"origin", 5101},
+    {"resource_opt2", 5091},
+    {"resource_opt3", 5150},
+    {"resource_opt4", 20011},
+};
+
+static perf_config testConfig(int frames) {
+    perf_config cfg = defaultPerfConfig();
+    cfg.frame_length = SIGNAL_LENGTH;
+    cfg.frames = frames;
+    return cfg;
+}
+
+int main() {
+    int errors = 0;
+
+    // One rewound II=1 process: the frames stream back to back, each done
+    // depth cycles after its last sample
+    {
+        process_spec map = {"map", 1, 10, 2, 0, false, false};
+        dataflow_model model(vector<process_spec>(1, map), testConfig(4));
+        perf_result r = model.run();
+        if (!r.completed || r.frames[0].latency() != SIGNAL_LENGTH + 10 || fabs(r.interval() - SIGNAL_LENGTH) > 0.5) {
+            cerr << "Map process: latency " << r.frames[0].latency() << ", interval " << r.interval() << endl;
+            errors++;
+        }
+    }
+
+    // An II=4 stage sets the interval to 4 cycles per sample and blocks the
+    // process and the input in front of it
+    {
+        vector<process_spec> chain;
+        process_spec fe = {"fe", 1, 2, 2, 0, false, false};
+        process_spec slow = {"slow", 4, 5, 2, 0, false, false};
+        process_spec peak = {"peak", 1, 3, 0, 0, true, true};
+        chain.push_back(fe);
+        chain.push_back(slow);
+        chain.push_back(peak);
+        dataflow_model model(chain, testConfig(4));
+        perf_result r = model.run();
+        if (!r.completed || fabs(r.interval() - 4 * SIGNAL_LENGTH) > 0.5 || r.bottleneck(chain) != 1 ||
+            r.processes[0].blocked == 0 || r.input_blocked == 0 || r.processes[2].blocked != 0) {
+            cerr << "II=4 stage: interval " << r.interval() << ", bottleneck " << chain[r.bottleneck(chain)].name << endl;
+            errors++;
+        }
+    }
+
+    // A process that is not rewound pays its prologue and drain every frame
+    {
+        process_spec filter = {"filter", 1, 20, 4, 30, false, true};
+        process_spec peak = {"peak", 1, 3, 0, 0, true, true};
+        vector<process_spec> chain;
+        chain.push_back(filter);
+        chain.push_back(peak);
+        dataflow_model model(chain, testConfig(4));
+        perf_result r = model.run();
+        double expected = SIGNAL_LENGTH + 20 + 1 + 30;
+        if (!r.completed || fabs(r.interval() - expected) > 2) {
+            cerr << "Drained process: interval " << r.interval() << ", expected about " << expected << endl;
+            errors++;
+        }
+    }
+
+    // A single frame of each variant, from the start to the peak, against
+    // cosim. The FIR IP latency of resource_opt4 is not in the log and is an
+    // estimate in variantChain.
+    for (size_t v = 0; v < sizeof(cosim) / sizeof(cosim[0]); v++) {
+        vector<process_spec> chain;
+        if (!variantChain(cosim[v].variant, 64, chain)) {
+            cerr << "No chain for " << cosim[v].variant << endl;
+            errors++;
+            continue;
+        }
+        dataflow_model model(chain, testConfig(1));
+        perf_result r = model.run();
+        double error = fabs((double)r.cycles - cosim[v].cycles) / cosim[v].cycles;
+        cout << cosim[v].variant << ": model " << r.cycles << " cycles, cosim " << cosim[v].cycles << " ("
+             << 100 * error << "%)" << endl;
+        if (!r.completed || error > 0.01) {
+            errors++;
+        }
+    }
+
+    // The sink process of a -s chain has no output stream, so its fifo
+    // depth may be 0 as in variantChain
+    {
+        process_spec sink;
+        process_spec bad;
+        if (!parseProcess("peakFinder,1,3,0,0,r", sink) || sink.fifo_depth != 0 || !sink.reduce ||
+            parseProcess("peakFinder,1,3,-1", bad)) {
+            cerr << "parseProcess: sink fifo depth" << endl;
+            errors++;
+        }
+    }
+
+    if (errors) {
+        cout << "Test failed with " << errors << " errors" << endl;
+        return 1;
+    }
+    cout << "Test passed!" << endl;
+    return 0;
+}
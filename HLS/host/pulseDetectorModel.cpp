@@ -0,0 +1,393 @@
+#include "pulseDetectorModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MODEL_X86 1
+#include <immintrin.h>
+#else
+#define MODEL_X86 0
+#endif
+
+namespace detector {
+namespace model {
+
+// FIR IP quantisation (resource_opt4 fir_settings)
+const int FIR_INPUT_WIDTH = 16;
+const int FIR_COEFF_FRAC_BITS = 15;
+const int FIR_OUTPUT_FRAC_BITS = 30;
+
+int32_t toFixed(double v) {
+    return wrapWord((int64_t)std::floor(std::ldexp(v, FIXED_FRAC_BITS)), FIXED_WIDTH);
+}
+
+double fromFixed(int32_t w) {
+    return std::ldexp((double)w, -FIXED_FRAC_BITS);
+}
+
+model_isa bestIsa() {
+#if MODEL_X86
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return ISA_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return ISA_AVX2;
+    }
+#endif
+    return ISA_SCALAR;
+}
+
+const char* isaName(model_isa isa) {
+    switch (isa) {
+    case ISA_AVX512: return "avx512";
+    case ISA_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+// Correlator kernels. All of them compute, for n in [0, length),
+//   acc[n] = sum over taps j of floor(in[n + T-1 - j] * c[j] / 2^SHIFT)   (mod 2^32)
+// where in[] carries T-1 leading zeros. Only the low bits of acc are used
+// afterwards, and the wrap of the HLS accumulator commutes with the sum, so a
+// 32-bit wrapping sum is exact.
+
+// Three-real datapath: 18/19-bit operands, 37-bit products, each truncated by
+// 16 bits as the ap_fixed<18,2> accumulator does on every +=
+static void convolve32Scalar(const int32_t* in, const int32_t* taps, int T, int length, int32_t* acc) {
+    for (int n = 0; n < length; n++) {
+        const int32_t* base = in + n + T - 1;
+        uint32_t sum = 0;
+        for (int j = 0; j < T; j++) {
+            sum += (uint32_t)(((int64_t)base[-j] * taps[j]) >> FIXED_FRAC_BITS);
+        }
+        acc[n] = (int32_t)sum;
+    }
+}
+
+// FIR IP datapath: 16-bit operands, products kept at full precision
+static void convolvePairsScalar(const int32_t* pairs, const int32_t* tapPairs, int T, int length, int32_t* acc) {
+    for (int n = 0; n < length; n++) {
+        const int32_t* base = pairs + n + T - 1;
+        uint32_t sum = 0;
+        for (int q = 0; q < T / 2; q++) {
+            int32_t x = base[-2 * q];
+            int32_t c = tapPairs[q];
+            sum += (uint32_t)((int32_t)(int16_t)x * (int16_t)c);
+            sum += (uint32_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(c >> 16));
+        }
+        acc[n] = (int32_t)sum;
+    }
+}
+
+#if MODEL_X86
+
+// _mm256_mul_epi32 gives exact 64-bit products of the even lanes; the odd
+// lanes are shifted down and multiplied separately. A logical 64-bit shift
+// leaves the same low 32 bits as the arithmetic one the scalar code uses.
+__attribute__((target("avx2")))
+static void convolve32Avx2(const int32_t* in, const int32_t* taps, int T, int length, int32_t* acc) {
+    int n = 0;
+    for (; n + 8 <= length; n += 8) {
+        const int32_t* base = in + n + T - 1;
+        __m256i acc_e = _mm256_setzero_si256();
+        __m256i acc_o = _mm256_setzero_si256();
+        for (int j = 0; j < T; j++) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(base - j));
+            __m256i c = _mm256_set1_epi32(taps[j]);
+            __m256i pe = _mm256_srli_epi64(_mm256_mul_epi32(x, c), FIXED_FRAC_BITS);
+            __m256i po = _mm256_srli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(x, 32), c), FIXED_FRAC_BITS);
+            acc_e = _mm256_add_epi32(acc_e, pe);
+            acc_o = _mm256_add_epi32(acc_o, po);
+        }
+        __m256i sum = _mm256_blend_epi32(acc_e, _mm256_slli_epi64(acc_o, 32), 0xAA);
+        _mm256_storeu_si256((__m256i*)(acc + n), sum);
+    }
+    convolve32Scalar(in + n, taps, T, length - n, acc + n);
+}
+
+// Two taps per 32-bit lane: (x[m], x[m-1]) against (c[j], c[j+1])
+__attribute__((target("avx2")))
+static void convolvePairsAvx2(const int32_t* pairs, const int32_t* tapPairs, int T, int length, int32_t* acc) {
+    int n = 0;
+    for (; n + 8 <= length; n += 8) {
+        const int32_t* base = pairs + n + T - 1;
+        __m256i sum = _mm256_setzero_si256();
+        for (int q = 0; q < T / 2; q++) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(base - 2 * q));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, _mm256_set1_epi32(tapPairs[q])));
+        }
+        _mm256_storeu_si256((__m256i*)(acc + n), sum);
+    }
+    convolvePairsScalar(pairs + n, tapPairs, T, length - n, acc + n);
+}
+
+// The AVX-512 kernels are register-blocked: each tap is broadcast once and
+// applied to AVX512_BLOCK output vectors held in registers, so the inner loop
+// is loads and multiply-adds only. Without blocking, every 16 outputs reload
+// and re-broadcast every tap into a single accumulator chain.
+const int AVX512_BLOCK = 8;
+
+__attribute__((target("avx512f,avx512bw")))
+static void convolve32Avx512(const int32_t* in, const int32_t* taps, int T, int length, int32_t* acc) {
+    int n = 0;
+    for (; n + 16 * AVX512_BLOCK <= length; n += 16 * AVX512_BLOCK) {
+        const int32_t* base = in + n + T - 1;
+        __m512i acc_e[AVX512_BLOCK], acc_o[AVX512_BLOCK];
+        for (int b = 0; b < AVX512_BLOCK; b++) {
+            acc_e[b] = _mm512_setzero_si512();
+            acc_o[b] = _mm512_setzero_si512();
+        }
+        for (int j = 0; j < T; j++) {
+            __m512i c = _mm512_set1_epi32(taps[j]);
+            for (int b = 0; b < AVX512_BLOCK; b++) {
+                __m512i x = _mm512_loadu_si512((const void*)(base + 16 * b - j));
+                __m512i pe = _mm512_srli_epi64(_mm512_mul_epi32(x, c), FIXED_FRAC_BITS);
+                __m512i po = _mm512_srli_epi64(_mm512_mul_epi32(_mm512_srli_epi64(x, 32), c), FIXED_FRAC_BITS);
+                acc_e[b] = _mm512_add_epi32(acc_e[b], pe);
+                acc_o[b] = _mm512_add_epi32(acc_o[b], po);
+            }
+        }
+        for (int b = 0; b < AVX512_BLOCK; b++) {
+            __m512i sum = _mm512_mask_blend_epi32(0xAAAA, acc_e[b], _mm512_slli_epi64(acc_o[b], 32));
+            _mm512_storeu_si512((void*)(acc + n + 16 * b), sum);
+        }
+    }
+    convolve32Avx2(in + n, taps, T, length - n, acc + n);
+}
+
+// vpmaddwd: 32 16-bit multiplies and 16 pair sums per instruction
+__attribute__((target("avx512f,avx512bw")))
+static void convolvePairsAvx512(const int32_t* pairs, const int32_t* tapPairs, int T, int length, int32_t* acc) {
+    int n = 0;
+    for (; n + 16 * AVX512_BLOCK <= length; n += 16 * AVX512_BLOCK) {
+        const int32_t* base = pairs + n + T - 1;
+        __m512i sum[AVX512_BLOCK];
+        for (int b = 0; b < AVX512_BLOCK; b++) {
+            sum[b] = _mm512_setzero_si512();
+        }
+        for (int q = 0; q < T / 2; q++) {
+            __m512i c = _mm512_set1_epi32(tapPairs[q]);
+            for (int b = 0; b < AVX512_BLOCK; b++) {
+                __m512i x = _mm512_loadu_si512((const void*)(base + 16 * b - 2 * q));
+                sum[b] = _mm512_add_epi32(sum[b], _mm512_madd_epi16(x, c));
+            }
+        }
+        for (int b = 0; b < AVX512_BLOCK; b++) {
+            _mm512_storeu_si512((void*)(acc + n + 16 * b), sum[b]);
+        }
+    }
+    convolvePairsAvx2(pairs + n, tapPairs, T, length - n, acc + n);
+}
+
+#endif
+
+static int32_t pack16(int32_t lo, int32_t hi) {
+    return (int32_t)(((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFF));
+}
+
+// The datapaths around the kernels: front end, three convolutions and back
+// end. The elementwise stages are inlined into one copy per ISA, so they are
+// vectorised at the width of the kernels; built for the baseline ISA they
+// took longer than the AVX-512 kernels themselves.
+typedef void (*convolve_kernel)(const int32_t* in, const int32_t* taps, int T, int length, int32_t* acc);
+
+struct filter_buffers {
+    int T;
+    const int32_t* taps[3];
+    int32_t* in[3]; // T-1 leading zeros, then length inputs
+    int32_t* acc[3];
+};
+
+#define MODEL_INLINE inline __attribute__((always_inline))
+
+static MODEL_INLINE void threeRealFilter(convolve_kernel kernel, const int32_t* rx_re, const int32_t* rx_im, int length, int stride,
+                                         const filter_buffers& b, int32_t* mag) {
+    const int pad = b.T - 1;
+    for (int n = 0; n < length; n++) {
+        int32_t re = rx_re[(size_t)n * stride];
+        int32_t im = rx_im[(size_t)n * stride];
+        b.in[0][pad + n] = re;
+        b.in[1][pad + n] = im;
+        b.in[2][pad + n] = re + im; // exact, ap_fixed<19,3>
+    }
+
+    for (int k = 0; k < 3; k++) {
+        kernel(b.in[k], b.taps[k], b.T, length, b.acc[k]);
+    }
+
+    for (int n = 0; n < length; n++) {
+        int32_t conv_real = wrapWord(b.acc[0][n], FIXED_WIDTH);
+        int32_t conv_imag = wrapWord(b.acc[1][n], FIXED_WIDTH);
+        int32_t conv_plus = wrapWord(b.acc[2][n], FIXED_WIDTH);
+        int64_t real = wrapWord(conv_real - conv_plus, FIXED_WIDTH);
+        int64_t imag = wrapWord(conv_imag + conv_plus, FIXED_WIDTH);
+        mag[n] = wrapWord((real * real + imag * imag) >> FIXED_FRAC_BITS, FIXED_WIDTH);
+    }
+}
+
+static MODEL_INLINE void firIpFilter(convolve_kernel kernel, const int32_t* rx_re, const int32_t* rx_im, int length, int stride,
+                                     const filter_buffers& b, int32_t* mag) {
+    const int pad = b.T - 1;
+
+    // process_fe: ap_fixed<18,2> -> s_data_t drops one fractional bit, and
+    // the re+im input is formed in s_data_t
+    for (int n = 0; n < length; n++) {
+        int32_t x_re = wrapWord(rx_re[(size_t)n * stride] >> 1, FIR_INPUT_WIDTH);
+        int32_t x_im = wrapWord(rx_im[(size_t)n * stride] >> 1, FIR_INPUT_WIDTH);
+        b.in[0][pad + n] = x_re;
+        b.in[1][pad + n] = x_im;
+        b.in[2][pad + n] = wrapWord(x_re + x_im, FIR_INPUT_WIDTH);
+    }
+    // Each word also carries the previous sample in its upper half for the
+    // pair kernels. Packing runs backwards, so every word reads its
+    // predecessor before that is packed; the zero ahead of sample 0 is the
+    // cleared delay line.
+    for (int k = 0; k < 3; k++) {
+        for (int n = length - 1; n >= 0; n--) {
+            b.in[k][pad + n] = pack16(b.in[k][pad + n], b.in[k][pad + n - 1]);
+        }
+    }
+
+    for (int k = 0; k < 3; k++) {
+        kernel(b.in[k], b.taps[k], b.T, length, b.acc[k]);
+    }
+
+    // process_be: m_data_t (30 fractional bits) -> ap_fixed<18,2>
+    const int shift = FIR_OUTPUT_FRAC_BITS - FIXED_FRAC_BITS;
+    for (int n = 0; n < length; n++) {
+        int32_t val1 = wrapWord(b.acc[0][n] >> shift, FIXED_WIDTH);
+        int32_t val2 = wrapWord(b.acc[1][n] >> shift, FIXED_WIDTH);
+        int32_t val3 = wrapWord(b.acc[2][n] >> shift, FIXED_WIDTH);
+        int64_t real = wrapWord(val1 - val3, FIXED_WIDTH);
+        int64_t imag = wrapWord(val2 + val3, FIXED_WIDTH);
+        mag[n] = wrapWord((real * real + imag * imag) >> FIXED_FRAC_BITS, FIXED_WIDTH);
+    }
+}
+
+#if MODEL_X86
+
+__attribute__((target("avx2")))
+static void threeRealFilterAvx2(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, const filter_buffers& b, int32_t* mag) {
+    threeRealFilter(convolve32Avx2, rx_re, rx_im, length, stride, b, mag);
+}
+
+__attribute__((target("avx2")))
+static void firIpFilterAvx2(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, const filter_buffers& b, int32_t* mag) {
+    firIpFilter(convolvePairsAvx2, rx_re, rx_im, length, stride, b, mag);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void threeRealFilterAvx512(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, const filter_buffers& b, int32_t* mag) {
+    threeRealFilter(convolve32Avx512, rx_re, rx_im, length, stride, b, mag);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void firIpFilterAvx512(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, const filter_buffers& b, int32_t* mag) {
+    firIpFilter(convolvePairsAvx512, rx_re, rx_im, length, stride, b, mag);
+}
+
+#endif
+
+pulse_detector_model::pulse_detector_model(const double (*taps)[3], int num_taps, model_arch arch, model_isa isa)
+    : num_taps(num_taps), pair_taps((num_taps + 1) & ~1), arch_(arch), isa_(isa) {
+    if (isa_ > bestIsa()) {
+        isa_ = bestIsa();
+    }
+
+    for (int k = 0; k < 3; k++) {
+        if (arch_ == ARCH_THREE_REAL) {
+            taps32[k].resize(num_taps);
+            for (int j = 0; j < num_taps; j++) {
+                taps32[k][j] = toFixed(taps[j][k]);
+            }
+        } else {
+            // The FIR IP rounds its coefficients to COEFF_FRACTIONAL_BITS
+            std::vector<int32_t> c(pair_taps, 0);
+            for (int j = 0; j < num_taps; j++) {
+                c[j] = wrapWord((int64_t)std::floor(std::ldexp(taps[j][k], FIR_COEFF_FRAC_BITS) + 0.5), FIR_INPUT_WIDTH);
+            }
+            tapPairs[k].resize(pair_taps / 2);
+            for (int q = 0; q < pair_taps / 2; q++) {
+                tapPairs[k][q] = pack16(c[2 * q], c[2 * q + 1]);
+            }
+        }
+    }
+}
+
+void pulse_detector_model::matchFilterThreeReal(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, int32_t* mag) {
+    filter_buffers b;
+    b.T = num_taps;
+    for (int k = 0; k < 3; k++) {
+        in32[k].resize(num_taps - 1 + length);
+        std::fill(in32[k].begin(), in32[k].begin() + num_taps - 1, 0);
+        acc[k].resize(length);
+        b.taps[k] = taps32[k].data();
+        b.in[k] = in32[k].data();
+        b.acc[k] = acc[k].data();
+    }
+
+#if MODEL_X86
+    if (isa_ == ISA_AVX512) {
+        threeRealFilterAvx512(rx_re, rx_im, length, stride, b, mag);
+        return;
+    }
+    if (isa_ == ISA_AVX2) {
+        threeRealFilterAvx2(rx_re, rx_im, length, stride, b, mag);
+        return;
+    }
+#endif
+    threeRealFilter(convolve32Scalar, rx_re, rx_im, length, stride, b, mag);
+}
+
+void pulse_detector_model::matchFilterFirIp(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, int32_t* mag) {
+    filter_buffers b;
+    b.T = pair_taps;
+    for (int k = 0; k < 3; k++) {
+        inPairs[k].resize(pair_taps - 1 + length);
+        std::fill(inPairs[k].begin(), inPairs[k].begin() + pair_taps - 1, 0);
+        acc[k].resize(length);
+        b.taps[k] = tapPairs[k].data();
+        b.in[k] = inPairs[k].data();
+        b.acc[k] = acc[k].data();
+    }
+
+#if MODEL_X86
+    if (isa_ == ISA_AVX512) {
+        firIpFilterAvx512(rx_re, rx_im, length, stride, b, mag);
+        return;
+    }
+    if (isa_ == ISA_AVX2) {
+        firIpFilterAvx2(rx_re, rx_im, length, stride, b, mag);
+        return;
+    }
+#endif
+    firIpFilter(convolvePairsScalar, rx_re, rx_im, length, stride, b, mag);
+}
+
+void pulse_detector_model::matchFilter(const int32_t* rx_re, const int32_t* rx_im, int length, int32_t* mag, int stride) {
+    if (arch_ == ARCH_THREE_REAL) {
+        matchFilterThreeReal(rx_re, rx_im, length, stride, mag);
+    } else {
+        matchFilterFirIp(rx_re, rx_im, length, stride, mag);
+    }
+}
+
+void pulse_detector_model::pulseDetector(const int32_t* rx_re, const int32_t* rx_im, int length, int32_t& peak, int& location, int stride) {
+    magBuff.resize(length);
+    matchFilter(rx_re, rx_im, length, magBuff.data(), stride);
+
+    int32_t current_peak = 0;
+    int current_location = 0;
+    for (int n = 0; n < length; n++) {
+        if (magBuff[n] > current_peak) {
+            current_peak = magBuff[n];
+            current_location = n;
+        }
+    }
+
+    peak = current_peak;
+    location = current_location;
+}
+
+} // namespace model
+} // namespace detector
@@ -0,0 +1,92 @@
+#ifndef PULSE_DETECTOR_MODEL_HPP
+#define PULSE_DETECTOR_MODEL_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Host software model of the resource_opt3 / resource_opt4 datapath on plain
+// integers. Samples, taps and results are raw two's complement words of the
+// HLS types, so every output is bit-identical to csim of the ap_fixed code:
+//   ap_fixed<18, 2>  fixed_point  -> int32_t, 16 fractional bits
+//   ap_fixed<16, 1>  s_data_t     -> int16_t, 15 fractional bits (FIR IP input)
+// No ap_fixed or hls::stream is involved, and the correlator runs on AVX2 or
+// AVX-512 integer kernels when the host supports them.
+namespace detector {
+namespace model {
+
+const int FIXED_WIDTH = 18;
+const int FIXED_FRAC_BITS = 16;
+
+// Datapath being modelled
+enum model_arch {
+    ARCH_THREE_REAL, // resource_opt3: three real filters in ap_fixed<18,2>
+    ARCH_FIR_IP      // resource_opt4: FIR IP cores, 16-bit in, full precision, process_be
+};
+
+// Correlator kernel
+enum model_isa {
+    ISA_SCALAR,
+    ISA_AVX2,
+    ISA_AVX512
+};
+
+// Sign-extend the low WIDTH bits, i.e. the AP_WRAP overflow of the HLS types
+inline int32_t wrapWord(int64_t v, int width) {
+    return (int32_t)((int64_t)((uint64_t)v << (64 - width)) >> (64 - width));
+}
+
+// ap_fixed<18,2>(double): truncate towards minus infinity, then wrap
+int32_t toFixed(double v);
+double fromFixed(int32_t w);
+
+// Widest kernel supported by this host
+model_isa bestIsa();
+const char* isaName(model_isa isa);
+
+class pulse_detector_model {
+public:
+    // taps[j][0..2] hold re+im, re-im and im of template tap j, as in
+    // templateTaps.hpp (threeRealTaps or a firTaps set).
+    // They are quantised the way the hardware does: truncated to
+    // ap_fixed<18,2>, or rounded to the FIR IP coefficient width.
+    pulse_detector_model(const double (*taps)[3], int num_taps, model_arch arch, model_isa isa = bestIsa());
+
+    int numTaps() const { return num_taps; }
+    model_arch arch() const { return arch_; }
+    model_isa isa() const { return isa_; }
+
+    // One frame from a cleared delay line (pulseDetector). rx_re/rx_im are
+    // ap_fixed<18,2> words, stride words apart, so stride 2 with
+    // rx_im = rx_re + 1 reads an interleaved IQ capture in place; mag
+    // receives length magnitude-squared words.
+    void matchFilter(const int32_t* rx_re, const int32_t* rx_im, int length, int32_t* mag, int stride = 1);
+
+    // matchFilter followed by peakFinder: first strict maximum, 0 if none
+    void pulseDetector(const int32_t* rx_re, const int32_t* rx_im, int length, int32_t& peak, int& location, int stride = 1);
+
+private:
+    void matchFilterThreeReal(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, int32_t* mag);
+    void matchFilterFirIp(const int32_t* rx_re, const int32_t* rx_im, int length, int stride, int32_t* mag);
+
+    int num_taps;
+    int pair_taps; // num_taps rounded up to even for the 16-bit pair kernels
+    model_arch arch_;
+    model_isa isa_;
+
+    // ARCH_THREE_REAL: ap_fixed<18,2> taps per filter
+    std::vector<int32_t> taps32[3];
+    // ARCH_FIR_IP: (c[j], c[j+1]) 16-bit pairs packed in one word per filter
+    std::vector<int32_t> tapPairs[3];
+
+    // Work buffers, reused across frames. The inputs are stored with
+    // num_taps-1 leading zeros, which is the cleared delay line.
+    std::vector<int32_t> in32[3];
+    std::vector<int32_t> inPairs[3];
+    std::vector<int32_t> acc[3];
+    std::vector<int32_t> magBuff;
+};
+
+} // namespace model
+} // namespace detector
+
+#endif
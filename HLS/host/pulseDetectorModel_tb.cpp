@@ -0,0 +1,146 @@
+#include "pulseDetectorModel.hpp"
+#include "templateTaps.hpp"
+#include "../common/pulseDetectorFirIp.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+
+using namespace std;
+using namespace detector::model;
+
+#define FILTER_LENGTH 64
+#define SIGNAL_LENGTH 5000
+
+// Frames replayed through the model for the throughput figure
+#define BENCH_FRAMES 200
+
+// ap_fixed reference: the resource_opt3 and resource_opt4 datapaths built from the same core
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<18, 2> > detector_cfg;
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+struct fir_settings {
+    static const unsigned input_width = 16;
+    static const unsigned input_fractional_bits = 15;
+    static const unsigned output_width = 32;
+    static const unsigned output_fractional_bits = 30;
+    static const unsigned coeff_width = 16;
+    static const unsigned coeff_fractional_bits = 15;
+    static const unsigned coeff_sets = 1;
+    static const unsigned num_channels = 1;
+    static const unsigned sample_period = 4;
+    static const unsigned sample_frequency = 64;
+
+    static constexpr double coeff(int filter, int i) {
+        return template_taps::value(i, filter - 1);
+    }
+};
+
+// The kernels' ROM, from the same tables as the model's taps
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = detector::coeff::tap_rom<fixed_point, template_taps>::value;
+
+static void referenceFilter(detector::model::model_arch arch, const complex_fixed_point* rx, int32_t* mag) {
+    detector_cfg::complex_stream RxSignal;
+    detector_cfg::real_stream FilterOut;
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        RxSignal.write(rx[n]);
+    }
+
+    if (arch == ARCH_THREE_REAL) {
+        detector::matchFilter<detector_cfg, detector::three_real_mult<detector_cfg> >(RxSignal, corrFilterBuff, FilterOut);
+    } else {
+        detector::fir_ip<detector_cfg, fir_settings>::matchFilter(RxSignal, FilterOut);
+    }
+
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        mag[n] = toFixed(FilterOut.read().to_double());
+    }
+}
+
+int main() {
+    static complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    static int32_t rx_re[SIGNAL_LENGTH], rx_im[SIGNAL_LENGTH];
+    static int32_t mag_ref[SIGNAL_LENGTH], mag_model[SIGNAL_LENGTH];
+    double fir_taps[FILTER_LENGTH][3];
+    int location_ref;
+    int i;
+    bool passed = true;
+
+    // Read RxSignal from the binary capture, converted from the resource_opt3
+    // text export on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "../resource_opt3/RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        rx_re[i] = rx_capture.data()[2 * i];
+        rx_im[i] = rx_capture.data()[2 * i + 1];
+    }
+
+    ifstream location_file("../resource_opt3/location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // The model gets the same taps as doubles and quantises them itself;
+    // the FIR IP cores run coefficient set 0
+    firTaps(0, fir_taps);
+
+    const model_arch archs[2] = {ARCH_THREE_REAL, ARCH_FIR_IP};
+    const char* archNames[2] = {"three-real", "fir-ip"};
+    const model_isa isas[3] = {ISA_SCALAR, ISA_AVX2, ISA_AVX512};
+
+    for (int a = 0; a < 2; a++) {
+        auto t0 = chrono::steady_clock::now();
+        referenceFilter(archs[a], rxSignalArray, mag_ref);
+        double ref_seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        for (int s = 0; s < 3; s++) {
+            if (isas[s] > bestIsa()) {
+                continue;
+            }
+            pulse_detector_model model(archs[a] == ARCH_THREE_REAL ? threeRealTaps : fir_taps, FILTER_LENGTH, archs[a], isas[s]);
+
+            // Every filter output word must match the ap_fixed model
+            model.matchFilter(rx_re, rx_im, SIGNAL_LENGTH, mag_model);
+            int mismatches = 0;
+            for (int n = 0; n < SIGNAL_LENGTH; n++) {
+                if (mag_model[n] != mag_ref[n]) {
+                    mismatches++;
+                }
+            }
+
+            int32_t peak;
+            int location;
+            t0 = chrono::steady_clock::now();
+            for (int f = 0; f < BENCH_FRAMES; f++) {
+                model.pulseDetector(rx_re, rx_im, SIGNAL_LENGTH, peak, location);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+            cout << "Model " << archNames[a] << "/" << isaName(model.isa()) << ": Peak: " << fromFixed(peak)
+                 << ", Location: " << location << ", Mismatches: " << mismatches
+                 << ", MSPS: " << BENCH_FRAMES * (double)SIGNAL_LENGTH / seconds / 1e6
+                 << " (csim " << SIGNAL_LENGTH / ref_seconds / 1e6 << ")" << endl;
+
+            if (mismatches != 0 || location + 1 != location_ref) {
+                passed = false;
+            }
+        }
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
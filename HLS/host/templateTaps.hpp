@@ -0,0 +1,35 @@
+#ifndef TEMPLATE_TAPS_HPP
+#define TEMPLATE_TAPS_HPP
+
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Compiled-in templates of the HLS variants as doubles, in the column order
+// the host model takes: re+im, re-im, im. They come from the same constexpr
+// transform as the kernels, so the words are identical.
+namespace detector {
+namespace model {
+
+const int TEMPLATE_TAPS = recorded_template::length;
+
+// resource_opt3 and resource_opt4 tap word: ap_fixed<18,2>
+typedef coeff::three_real_taps<recorded_template, TEMPLATE_TAPS, 18, 16> template_taps;
+typedef coeff::three_real_taps<coeff::conjugate<recorded_template>, TEMPLATE_TAPS, 18, 16> conjugate_taps;
+
+// resource_opt3
+static const double (&threeRealTaps)[TEMPLATE_TAPS][3] = coeff::tap_rom<double, template_taps>::value;
+
+// Coefficient set `set` of the resource_opt4 FIR IP cores in model order:
+// 0 the template, 1 its conjugate
+inline void firTaps(int set, double taps[TEMPLATE_TAPS][3]) {
+    for (int j = 0; j < TEMPLATE_TAPS; j++) {
+        for (int k = 0; k < 3; k++) {
+            taps[j][k] = set == 0 ? template_taps::value(j, k) : conjugate_taps::value(j, k);
+        }
+    }
+}
+
+} // namespace model
+} // namespace detector
+
+#endif
@@ -0,0 +1,336 @@
+#include "wordLength.hpp"
+#include "workStealingPool.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+namespace detector {
+namespace model {
+
+// Products of two 40-bit words and their sums, exactly
+typedef __int128 wide_t;
+
+const char* stageName(int stage) {
+    static const char* const names[NUM_STAGES] = {"input", "coef", "acc", "mag", "peak"};
+    return names[stage];
+}
+
+static int fracBits(const fixed_format& f) {
+    return f.width - f.int_bits;
+}
+
+// Sign-extend the low width bits (AP_WRAP)
+static int64_t wrap(wide_t v, int width) {
+    int shift = 128 - width;
+    return (int64_t)((wide_t)((unsigned __int128)v << shift) >> shift);
+}
+
+// v with frac fractional bits scaled to to_frac >= frac
+static wide_t align(wide_t v, int frac, int to_frac) {
+    return (wide_t)((unsigned __int128)v << (to_frac - frac));
+}
+
+// ap_fixed(double): truncate towards minus infinity, then wrap
+static int64_t quantise(double v, const fixed_format& f) {
+    return wrap((wide_t)std::floor(std::ldexp(v, fracBits(f))), f.width);
+}
+
+// Assignment of an exact value with frac fractional bits to format f
+static int64_t requantise(wide_t v, int frac, const fixed_format& f) {
+    int to_frac = fracBits(f);
+    if (to_frac >= frac) {
+        return wrap(align(v, frac, to_frac), f.width);
+    }
+    return wrap(v >> (frac - to_frac), f.width); // arithmetic shift, i.e. floor
+}
+
+static double value(int64_t w, const fixed_format& f) {
+    return std::ldexp((double)w, -fracBits(f));
+}
+
+static double sqnr(double signal, double noise) {
+    if (noise == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10 * std::log10(signal / noise);
+}
+
+bool loadTextCaptureDouble(const std::string& path, std::vector<double>& re, std::vector<double>& im) {
+    std::ifstream file(path.c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+
+    re.clear();
+    im.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        const char* p = line.c_str();
+        char* end;
+        double real_part = std::strtod(p, &end);
+        if (end == p) {
+            continue;
+        }
+        p = end;
+        double imag_part = std::strtod(p, &end);
+        if (end == p) {
+            continue;
+        }
+        re.push_back(real_part);
+        im.push_back(imag_part);
+    }
+    return true;
+}
+
+word_length_analysis::word_length_analysis(const double (*taps_in)[3], int num_taps, int location_tolerance, int num_workers)
+    : num_taps(num_taps), location_tolerance(location_tolerance), num_workers(num_workers) {
+    for (int s = 0; s < NUM_STAGES; s++) {
+        max_abs[s] = 0;
+        signal[s] = 0;
+    }
+    for (int k = 0; k < 3; k++) {
+        taps[k].resize(num_taps);
+        for (int j = 0; j < num_taps; j++) {
+            taps[k][j] = taps_in[j][k];
+            max_abs[STAGE_COEF] = std::max(max_abs[STAGE_COEF], std::fabs(taps_in[j][k]));
+            signal[STAGE_COEF] += taps_in[j][k] * taps_in[j][k];
+        }
+    }
+}
+
+void word_length_analysis::addFrame(const double* re, const double* im, int length) {
+    frames.push_back(frame());
+    frame& f = frames.back();
+    f.re.assign(re, re + length);
+    f.im.assign(im, im + length);
+    f.real.resize(length);
+    f.imag.resize(length);
+    f.mag.resize(length);
+    f.peak = 0;
+    f.location = 0;
+
+    for (int n = 0; n < length; n++) {
+        double conv_real = 0;
+        double conv_imag = 0;
+        double conv_plus = 0;
+        for (int j = 0; j < num_taps && j <= n; j++) {
+            conv_real += re[n - j] * taps[0][j];
+            conv_imag += im[n - j] * taps[1][j];
+            conv_plus += (re[n - j] + im[n - j]) * taps[2][j];
+        }
+        f.real[n] = conv_real - conv_plus;
+        f.imag[n] = conv_imag + conv_plus;
+        f.mag[n] = f.real[n] * f.real[n] + f.imag[n] * f.imag[n];
+        if (f.mag[n] > f.peak) {
+            f.peak = f.mag[n];
+            f.location = n;
+        }
+
+        double acc_max = std::max(std::max(std::fabs(conv_real), std::fabs(conv_imag)), std::fabs(conv_plus));
+        acc_max = std::max(acc_max, std::max(std::fabs(f.real[n]), std::fabs(f.imag[n])));
+        max_abs[STAGE_INPUT] = std::max(max_abs[STAGE_INPUT], std::max(std::fabs(re[n]), std::fabs(im[n])));
+        max_abs[STAGE_ACC] = std::max(max_abs[STAGE_ACC], acc_max);
+        max_abs[STAGE_MAG] = std::max(max_abs[STAGE_MAG], f.mag[n]);
+
+        signal[STAGE_INPUT] += re[n] * re[n] + im[n] * im[n];
+        signal[STAGE_ACC] += f.real[n] * f.real[n] + f.imag[n] * f.imag[n];
+        signal[STAGE_MAG] += f.mag[n] * f.mag[n];
+    }
+    max_abs[STAGE_PEAK] = std::max(max_abs[STAGE_PEAK], f.peak);
+    signal[STAGE_PEAK] += f.peak * f.peak;
+}
+
+word_lengths word_length_analysis::fromRanges(const int width[NUM_STAGES], int headroom) const {
+    word_lengths wl;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        // Signed: [-2^(I-1), 2^(I-1)) must hold max_abs
+        int int_bits = max_abs[s] > 0 ? (int)std::floor(std::log2(max_abs[s])) + 2 : 1;
+        wl.format[s].width = width[s];
+        wl.format[s].int_bits = int_bits + headroom;
+    }
+    return wl;
+}
+
+void word_length_analysis::runFixed(const frame& f, const word_lengths& wl, std::vector<int64_t>& real,
+                                    std::vector<int64_t>& imag, std::vector<int64_t>& mag) const {
+    const fixed_format& in = wl.format[STAGE_INPUT];
+    const fixed_format& coef = wl.format[STAGE_COEF];
+    const fixed_format& acc = wl.format[STAGE_ACC];
+    const int length = (int)f.re.size();
+
+    std::vector<int64_t> re(length), im(length), c[3];
+    for (int n = 0; n < length; n++) {
+        re[n] = quantise(f.re[n], in);
+        im[n] = quantise(f.im[n], in);
+    }
+    for (int k = 0; k < 3; k++) {
+        c[k].resize(num_taps);
+        for (int j = 0; j < num_taps; j++) {
+            c[k][j] = quantise(taps[k][j], coef);
+        }
+    }
+
+    // Each += adds the exact product and truncates into the accumulator
+    const int prod_frac = fracBits(in) + fracBits(coef);
+    const int sum_frac = std::max(prod_frac, fracBits(acc));
+    real.resize(length);
+    imag.resize(length);
+    mag.resize(length);
+    for (int n = 0; n < length; n++) {
+        int64_t conv_real = 0;
+        int64_t conv_imag = 0;
+        int64_t conv_plus = 0;
+        for (int j = 0; j < num_taps && j <= n; j++) {
+            wide_t x_re = re[n - j];
+            wide_t x_im = im[n - j];
+            conv_real = requantise(align(conv_real, fracBits(acc), sum_frac) + align(x_re * c[0][j], prod_frac, sum_frac), sum_frac, acc);
+            conv_imag = requantise(align(conv_imag, fracBits(acc), sum_frac) + align(x_im * c[1][j], prod_frac, sum_frac), sum_frac, acc);
+            conv_plus = requantise(align(conv_plus, fracBits(acc), sum_frac) + align((x_re + x_im) * c[2][j], prod_frac, sum_frac), sum_frac, acc);
+        }
+        real[n] = wrap((wide_t)conv_real - conv_plus, acc.width);
+        imag[n] = wrap((wide_t)conv_imag + conv_plus, acc.width);
+        mag[n] = requantise((wide_t)real[n] * real[n] + (wide_t)imag[n] * imag[n], 2 * fracBits(acc), wl.format[STAGE_MAG]);
+    }
+}
+
+void word_length_analysis::matchFilter(int f, const word_lengths& wl, std::vector<int64_t>& mag) const {
+    std::vector<int64_t> real, imag;
+    runFixed(frames[f], wl, real, imag, mag);
+}
+
+void word_length_analysis::evaluateFrame(const frame& f, const word_lengths& wl, double noise[NUM_STAGES], bool& location_error) const {
+    std::vector<int64_t> real, imag, mag;
+    runFixed(f, wl, real, imag, mag);
+
+    for (int s = 0; s < NUM_STAGES; s++) {
+        noise[s] = 0;
+    }
+
+    // peakFinder: first strict maximum above 0
+    int64_t peak = 0;
+    int location = 0;
+    for (size_t n = 0; n < mag.size(); n++) {
+        double e_re = value(quantise(f.re[n], wl.format[STAGE_INPUT]), wl.format[STAGE_INPUT]) - f.re[n];
+        double e_im = value(quantise(f.im[n], wl.format[STAGE_INPUT]), wl.format[STAGE_INPUT]) - f.im[n];
+        double e_real = value(real[n], wl.format[STAGE_ACC]) - f.real[n];
+        double e_imag = value(imag[n], wl.format[STAGE_ACC]) - f.imag[n];
+        double e_mag = value(mag[n], wl.format[STAGE_MAG]) - f.mag[n];
+        noise[STAGE_INPUT] += e_re * e_re + e_im * e_im;
+        noise[STAGE_ACC] += e_real * e_real + e_imag * e_imag;
+        noise[STAGE_MAG] += e_mag * e_mag;
+
+        if (mag[n] > peak) {
+            peak = mag[n];
+            location = (int)n;
+        }
+    }
+
+    double e_peak = value(requantise(peak, fracBits(wl.format[STAGE_MAG]), wl.format[STAGE_PEAK]), wl.format[STAGE_PEAK]) - f.peak;
+    noise[STAGE_PEAK] = e_peak * e_peak;
+    location_error = std::abs(location - f.location) > location_tolerance;
+}
+
+wl_metrics word_length_analysis::evaluate(const word_lengths& wl) const {
+    const int num_frames = (int)frames.size();
+    std::vector<double> noise(num_frames * NUM_STAGES);
+    std::vector<char> errors(num_frames);
+
+    {
+        work_stealing_pool pool(num_workers);
+        for (int f = 0; f < num_frames; f++) {
+            pool.submit([&, f](int) {
+                bool location_error;
+                evaluateFrame(frames[f], wl, &noise[f * NUM_STAGES], location_error);
+                errors[f] = location_error;
+            });
+        }
+        pool.wait();
+    }
+
+    // Summed in frame order, so the result does not depend on the schedule
+    double total[NUM_STAGES] = {0};
+    wl_metrics m;
+    m.frames = num_frames;
+    m.location_errors = 0;
+    for (int f = 0; f < num_frames; f++) {
+        for (int s = 0; s < NUM_STAGES; s++) {
+            total[s] += noise[f * NUM_STAGES + s];
+        }
+        m.location_errors += errors[f];
+    }
+
+    for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < num_taps; j++) {
+            double e = value(quantise(taps[k][j], wl.format[STAGE_COEF]), wl.format[STAGE_COEF]) - taps[k][j];
+            total[STAGE_COEF] += e * e;
+        }
+    }
+
+    for (int s = 0; s < NUM_STAGES; s++) {
+        m.sqnr_db[s] = sqnr(signal[s], total[s]);
+    }
+    return m;
+}
+
+bool word_length_analysis::meets(const wl_metrics& m, const wl_target& target) {
+    return m.sqnr_db[STAGE_MAG] >= target.min_sqnr_db && m.sqnr_db[STAGE_PEAK] >= target.min_sqnr_db &&
+           m.locationErrorRate() <= target.max_location_errors;
+}
+
+word_lengths word_length_analysis::optimise(const word_lengths& start, const wl_target& target, const bool pinned[NUM_STAGES],
+                                            int min_width, std::ostream* log) const {
+    word_lengths wl = start;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        if (pinned[s]) {
+            continue;
+        }
+        // Narrow until the target is missed; the metrics only get worse
+        // with fewer bits, so the first failure ends the stage
+        int best = wl.format[s].width;
+        for (int width = best - 1; width >= min_width; width--) {
+            word_lengths trial = wl;
+            trial.format[s].width = width;
+            wl_metrics m = evaluate(trial);
+            if (log != NULL) {
+                writeRow(*log, std::string(stageName(s)) + (meets(m, target) ? "" : " (miss)"), trial, m);
+            }
+            if (!meets(m, target)) {
+                break;
+            }
+            best = width;
+        }
+        wl.format[s].width = best;
+    }
+    return wl;
+}
+
+std::string word_length_analysis::formatName(const fixed_format& f) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "<%d,%d>", f.width, f.int_bits);
+    return name;
+}
+
+void word_length_analysis::writeHeader(std::ostream& out) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-16s %-8s %-8s %-8s %-8s %-8s %9s %9s %9s %9s %9s %8s", "", "input", "coef", "acc",
+                  "mag", "peak", "in dB", "coef dB", "acc dB", "mag dB", "peak dB", "loc err");
+    out << line << std::endl;
+}
+
+void word_length_analysis::writeRow(std::ostream& out, const std::string& label, const word_lengths& wl, const wl_metrics& m) {
+    char line[256];
+    int n = std::snprintf(line, sizeof(line), "%-16s", label.c_str());
+    for (int s = 0; s < NUM_STAGES; s++) {
+        n += std::snprintf(line + n, sizeof(line) - n, " %-8s", formatName(wl.format[s]).c_str());
+    }
+    for (int s = 0; s < NUM_STAGES; s++) {
+        n += std::snprintf(line + n, sizeof(line) - n, " %9.1f", m.sqnr_db[s]);
+    }
+    std::snprintf(line + n, sizeof(line) - n, " %7.1f%%", 100 * m.locationErrorRate());
+    out << line << std::endl;
+}
+
+} // namespace model
+} // namespace detector
@@ -0,0 +1,123 @@
+#ifndef WORD_LENGTH_HPP
+#define WORD_LENGTH_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Word-length analysis of the three-real datapath (resource_opt3 and
+// resource_opt7). Each frame is run once in double precision and then at
+// candidate ap_fixed formats per stage, with the AP_TRN / AP_WRAP semantics
+// of the HLS types:
+//   input  re and im of a sample (re+im is formed exactly, one bit wider)
+//   coef   the three-real taps re+im, re-im and im
+//   acc    the correlator sums, truncated at every +=, and real / imag
+//   mag    real^2 + imag^2, the FilterOut stream
+//   peak   the peak value reported by the top function
+namespace detector {
+namespace model {
+
+enum wl_stage {
+    STAGE_INPUT,
+    STAGE_COEF,
+    STAGE_ACC,
+    STAGE_MAG,
+    STAGE_PEAK,
+    NUM_STAGES
+};
+
+const char* stageName(int stage);
+
+// ap_fixed<width, int_bits>; int_bits may be negative or exceed width
+struct fixed_format {
+    int width;
+    int int_bits;
+};
+
+struct word_lengths {
+    fixed_format format[NUM_STAGES];
+};
+
+// Accuracy of one set of word lengths against double precision
+struct wl_metrics {
+    double sqnr_db[NUM_STAGES]; // infinity when the stage is exact
+    int frames;
+    int location_errors;        // frames whose location moved by more than the tolerance
+
+    double locationErrorRate() const { return frames > 0 ? (double)location_errors / frames : 0; }
+};
+
+// Acceptance criteria for the search
+struct wl_target {
+    double min_sqnr_db;          // of both outputs, mag and peak
+    double max_location_errors;  // rate, 0 to 1
+};
+
+class word_length_analysis {
+public:
+    // taps[j][0..2] hold re+im, re-im and im of template tap j as doubles.
+    // A location within location_tolerance samples of the double-precision
+    // one is not an error.
+    word_length_analysis(const double (*taps)[3], int num_taps, int location_tolerance, int num_workers);
+
+    // Frames are kept in double precision, and their reference is computed once
+    void addFrame(const double* re, const double* im, int length);
+    int numFrames() const { return (int)frames.size(); }
+
+    // Largest magnitude seen at each stage over all frames
+    double maxAbs(int stage) const { return max_abs[stage]; }
+
+    // Integer bits for the ranges seen plus headroom, at the given widths
+    word_lengths fromRanges(const int width[NUM_STAGES], int headroom) const;
+
+    wl_metrics evaluate(const word_lengths& wl) const;
+
+    // Raw magnitude words of frame f at the given word lengths; at
+    // ap_fixed<18,2> throughout they are those of pulse_detector_model
+    void matchFilter(int f, const word_lengths& wl, std::vector<int64_t>& mag) const;
+
+    // Narrowest widths meeting the target, one stage at a time in datapath
+    // order with the later stages still at their start widths. Integer bits
+    // stay as in start; pinned stages are not changed. Each candidate is
+    // printed to log if given.
+    word_lengths optimise(const word_lengths& start, const wl_target& target, const bool pinned[NUM_STAGES], int min_width,
+                          std::ostream* log) const;
+
+    static bool meets(const wl_metrics& m, const wl_target& target);
+    static std::string formatName(const fixed_format& f);
+    static void writeHeader(std::ostream& out);
+    static void writeRow(std::ostream& out, const std::string& label, const word_lengths& wl, const wl_metrics& m);
+
+private:
+    struct frame {
+        std::vector<double> re, im;
+        std::vector<double> real, imag, mag; // double-precision reference
+        double peak;
+        int location;
+    };
+
+    // Fixed-point datapath: raw words of real, imag and mag
+    void runFixed(const frame& f, const word_lengths& wl, std::vector<int64_t>& real, std::vector<int64_t>& imag,
+                  std::vector<int64_t>& mag) const;
+
+    // Quantisation noise energy of one frame per stage (the signal energy is
+    // fixed by the reference) and whether the location is off
+    void evaluateFrame(const frame& f, const word_lengths& wl, double noise[NUM_STAGES], bool& location_error) const;
+
+    std::vector<double> taps[3];
+    int num_taps;
+    int location_tolerance;
+    int num_workers;
+    std::vector<frame> frames;
+    double max_abs[NUM_STAGES];
+    double signal[NUM_STAGES];
+};
+
+// Read a MATLAB text export ("re im" per line) without quantising it
+bool loadTextCaptureDouble(const std::string& path, std::vector<double>& re, std::vector<double>& im);
+
+} // namespace model
+} // namespace detector
+
+#endif
@@ -0,0 +1,185 @@
+#include "wordLength.hpp"
+#include "templateTaps.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace detector::model;
+
+// Weak returns for the synthetic frames: gains from 1 down to 2^-MAX_ATTENUATION_BITS
+#define MAX_ATTENUATION_BITS 5
+
+static void usage(const char* name) {
+    cerr << "Usage: " << name << " [-j threads] [-s min_sqnr_db, default 40] [-e max_location_error_rate, default 0]"
+         << " [-t location_tolerance, default 0] [-f frame_length, default 5000] [-r recorded_frames, default 16]"
+         << " [-n synthetic_frames, default 48] [-w start_width, default 24] [-m min_width, default 4]"
+         << " [-H headroom_bits, default 1] [-p stage=width,int_bits] ... [capture.txt]" << endl;
+    cerr << "Stages: input, coef, acc, mag, peak" << endl;
+}
+
+static unsigned lcgNext(unsigned& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static int stageIndex(const string& name) {
+    for (int s = 0; s < NUM_STAGES; s++) {
+        if (name == stageName(s)) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    int num_workers = (int)thread::hardware_concurrency();
+    wl_target target = {40.0, 0.0};
+    int tolerance = 0;
+    int frame_length = 5000;
+    int recorded_frames = 16;
+    int synthetic_frames = 48;
+    int start_width = 24;
+    int min_width = 4;
+    int headroom = 1;
+    bool pinned[NUM_STAGES] = {false};
+    fixed_format pins[NUM_STAGES];
+    const char* capture_path = "../resource_opt3/RxSignal_in.txt";
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* opt = argv[i];
+        const char* arg = argv[++i];
+        if (strcmp(opt, "-j") == 0) {
+            num_workers = atoi(arg);
+        } else if (strcmp(opt, "-s") == 0) {
+            target.min_sqnr_db = atof(arg);
+        } else if (strcmp(opt, "-e") == 0) {
+            target.max_location_errors = atof(arg);
+        } else if (strcmp(opt, "-t") == 0) {
+            tolerance = atoi(arg);
+        } else if (strcmp(opt, "-f") == 0) {
+            frame_length = atoi(arg);
+        } else if (strcmp(opt, "-r") == 0) {
+            recorded_frames = atoi(arg);
+        } else if (strcmp(opt, "-n") == 0) {
+            synthetic_frames = atoi(arg);
+        } else if (strcmp(opt, "-w") == 0) {
+            start_width = atoi(arg);
+        } else if (strcmp(opt, "-m") == 0) {
+            min_width = atoi(arg);
+        } else if (strcmp(opt, "-H") == 0) {
+            headroom = atoi(arg);
+        } else if (strcmp(opt, "-p") == 0) {
+            // stage=width,int_bits keeps that stage fixed, e.g. input=16,1 for a 16-bit ADC
+            const char* eq = strchr(arg, '=');
+            int s = eq != NULL ? stageIndex(string(arg, eq - arg)) : -1;
+            if (s < 0 || sscanf(eq + 1, "%d,%d", &pins[s].width, &pins[s].int_bits) != 2) {
+                usage(argv[0]);
+                return 1;
+            }
+            pinned[s] = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (i < argc) {
+        capture_path = argv[i++];
+    }
+    if (i != argc || num_workers < 1 || frame_length < 1 || start_width > 40 || min_width < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    vector<double> re, im;
+    if (!loadTextCaptureDouble(capture_path, re, im) || re.empty()) {
+        cerr << "Error opening " << capture_path << endl;
+        return 1;
+    }
+
+    // Recorded frames: circular windows of the capture at spread offsets.
+    // Synthetic frames: the same windows attenuated, for weak returns, plus
+    // uniform noise of one 18-bit LSB.
+    word_length_analysis analysis(threeRealTaps, TEMPLATE_TAPS, tolerance, num_workers);
+    const size_t num_samples = re.size();
+    vector<double> frame_re(frame_length), frame_im(frame_length);
+    unsigned state = 12345u;
+    for (int k = 0; k < recorded_frames + synthetic_frames; k++) {
+        size_t start = (size_t)k * 613 % num_samples;
+        double gain = 1;
+        double noise = 0;
+        if (k >= recorded_frames) {
+            gain = ldexp(1.0, -(int)(lcgNext(state) % (MAX_ATTENUATION_BITS + 1)));
+            noise = ldexp(1.0, -16);
+        }
+        for (int n = 0; n < frame_length; n++) {
+            size_t src = (start + n) % num_samples;
+            frame_re[n] = gain * re[src] + noise * ((lcgNext(state) & 0xffff) / 32768.0 - 1);
+            frame_im[n] = gain * im[src] + noise * ((lcgNext(state) & 0xffff) / 32768.0 - 1);
+        }
+        analysis.addFrame(frame_re.data(), frame_im.data(), frame_length);
+    }
+
+    cout << "Frames: " << recorded_frames << " recorded, " << synthetic_frames << " synthetic, " << frame_length
+         << " samples; target: mag and peak SQNR >= " << target.min_sqnr_db << " dB, location errors <= "
+         << 100 * target.max_location_errors << "% (tolerance " << tolerance << ")" << endl;
+    cout << "Ranges (max |x|):";
+    for (int s = 0; s < NUM_STAGES; s++) {
+        cout << " " << stageName(s) << " " << analysis.maxAbs(s);
+    }
+    cout << endl << endl;
+
+    // The detector as it stands: ap_fixed<18,2> everywhere
+    word_lengths current;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        current.format[s].width = 18;
+        current.format[s].int_bits = 2;
+    }
+
+    int widths[NUM_STAGES];
+    for (int s = 0; s < NUM_STAGES; s++) {
+        widths[s] = start_width;
+    }
+    word_lengths start = analysis.fromRanges(widths, headroom);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        if (pinned[s]) {
+            start.format[s] = pins[s];
+        }
+    }
+
+    word_length_analysis::writeHeader(cout);
+    wl_metrics m = analysis.evaluate(current);
+    word_length_analysis::writeRow(cout, "current", current, m);
+    m = analysis.evaluate(start);
+    word_length_analysis::writeRow(cout, "start", start, m);
+    if (!word_length_analysis::meets(m, target)) {
+        cout << "The start widths miss the target; raise -w or relax -s / -e" << endl;
+        return 1;
+    }
+
+    word_lengths best = analysis.optimise(start, target, pinned, min_width, &cout);
+    m = analysis.evaluate(best);
+    word_length_analysis::writeRow(cout, "proposed", best, m);
+
+    // The three-real multipliers see the re+im input, one bit wider
+    int mult_a = best.format[STAGE_INPUT].width + 1;
+    int mult_b = best.format[STAGE_COEF].width;
+    bool one_dsp = (mult_a <= 25 && mult_b <= 18) || (mult_a <= 18 && mult_b <= 25);
+    cout << endl << "Multipliers: " << mult_a << " x " << mult_b << " bits, " << (one_dsp ? "one DSP48E1 each" : "more than one DSP48E1 each")
+         << endl;
+    cout << "typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH";
+    for (int s = STAGE_INPUT; s <= STAGE_MAG; s++) {
+        cout << ", ap_fixed" << word_length_analysis::formatName(best.format[s]);
+    }
+    cout << " > detector_cfg; // peak: ap_fixed" << word_length_analysis::formatName(best.format[STAGE_PEAK]) << endl;
+
+    return 0;
+}
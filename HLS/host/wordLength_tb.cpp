@@ -0,0 +1,92 @@
+#include "wordLength.hpp"
+#include "pulseDetectorModel.hpp"
+#include "templateTaps.hpp"
+#include <iostream>
+
+using namespace std;
+using namespace detector::model;
+
+#define SIGNAL_LENGTH 5000
+#define TEST_FRAMES 4
+
+int main() {
+    vector<double> re, im;
+    if (!loadTextCaptureDouble("../resource_opt3/RxSignal_in.txt", re, im) || (int)re.size() < SIGNAL_LENGTH) {
+        cerr << "Error opening ../resource_opt3/RxSignal_in.txt" << endl;
+        return 1;
+    }
+
+    // Circular windows of the capture, the pulse at a different place in each
+    word_length_analysis analysis(threeRealTaps, TEMPLATE_TAPS, 0, 1);
+    vector<double> frame_re(SIGNAL_LENGTH), frame_im(SIGNAL_LENGTH);
+    for (int f = 0; f < TEST_FRAMES; f++) {
+        for (int n = 0; n < SIGNAL_LENGTH; n++) {
+            frame_re[n] = re[(n + 1237 * f) % SIGNAL_LENGTH];
+            frame_im[n] = im[(n + 1237 * f) % SIGNAL_LENGTH];
+        }
+        analysis.addFrame(frame_re.data(), frame_im.data(), SIGNAL_LENGTH);
+    }
+
+    // At ap_fixed<18,2> throughout, every magnitude word must match the
+    // bit-exact host model of resource_opt3
+    word_lengths current;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        current.format[s].width = 18;
+        current.format[s].int_bits = 2;
+    }
+    pulse_detector_model model(threeRealTaps, TEMPLATE_TAPS, ARCH_THREE_REAL);
+    vector<int32_t> rx_re(SIGNAL_LENGTH), rx_im(SIGNAL_LENGTH), mag_model(SIGNAL_LENGTH);
+    vector<int64_t> mag;
+    int mismatches = 0;
+    for (int f = 0; f < TEST_FRAMES; f++) {
+        for (int n = 0; n < SIGNAL_LENGTH; n++) {
+            rx_re[n] = toFixed(re[(n + 1237 * f) % SIGNAL_LENGTH]);
+            rx_im[n] = toFixed(im[(n + 1237 * f) % SIGNAL_LENGTH]);
+        }
+        model.matchFilter(rx_re.data(), rx_im.data(), SIGNAL_LENGTH, mag_model.data());
+        analysis.matchFilter(f, current, mag);
+        for (int n = 0; n < SIGNAL_LENGTH; n++) {
+            mismatches += mag[n] != mag_model[n];
+        }
+    }
+    cout << "Mismatches against the host model at ap_fixed<18,2>: " << mismatches << endl;
+
+    // The proposal must meet the target and be no wider than the start
+    wl_target target = {40.0, 0.0};
+    int widths[NUM_STAGES] = {24, 24, 24, 24, 24};
+    bool pinned[NUM_STAGES] = {false};
+    word_lengths start = analysis.fromRanges(widths, 1);
+    word_lengths best = analysis.optimise(start, target, pinned, 4, NULL);
+
+    word_length_analysis::writeHeader(cout);
+    word_length_analysis::writeRow(cout, "current", current, analysis.evaluate(current));
+    word_length_analysis::writeRow(cout, "start", start, analysis.evaluate(start));
+    wl_metrics m = analysis.evaluate(best);
+    word_length_analysis::writeRow(cout, "proposed", best, m);
+
+    bool passed = mismatches == 0 && word_length_analysis::meets(m, target);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        if (best.format[s].width > start.format[s].width || best.format[s].int_bits != start.format[s].int_bits) {
+            passed = false;
+        }
+    }
+
+    // One bit less on any stage of the proposal misses the target or is
+    // below the minimum width
+    for (int s = 0; s < NUM_STAGES; s++) {
+        word_lengths narrower = best;
+        narrower.format[s].width--;
+        if (narrower.format[s].width >= 4 && word_length_analysis::meets(analysis.evaluate(narrower), target)) {
+            cout << "Stage " << stageName(s) << " could be narrower" << endl;
+            passed = false;
+        }
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+    } else {
+        cout << "Test failed!" << endl;
+    }
+
+    return passed ? 0 : 1;
+}
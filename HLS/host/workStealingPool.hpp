@@ -0,0 +1,154 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace detector {
+namespace model {
+
+// Fixed-size thread pool with one deque per worker. A worker pops its own
+// newest task first and, when empty, steals the oldest task of another
+// worker, so tasks spawned from a task (frames of a capture) stay local while
+// idle workers balance the load.
+class work_stealing_pool {
+public:
+    // The argument is the index of the worker running the task, for per-worker state
+    typedef std::function<void(int)> task_t;
+
+    explicit work_stealing_pool(int num_workers)
+        : queues(num_workers), steals(num_workers), executed(num_workers), queued(0), pending(0), stopping(false) {
+        for (int w = 0; w < num_workers; w++) {
+            queues[w].reset(new worker_queue);
+            steals[w] = 0;
+            executed[w] = 0;
+        }
+        for (int w = 0; w < num_workers; w++) {
+            threads.push_back(std::thread(&work_stealing_pool::workerLoop, this, w));
+        }
+    }
+
+    ~work_stealing_pool() {
+        {
+            std::lock_guard<std::mutex> lk(idle_lock);
+            stopping = true;
+        }
+        idle_cv.notify_all();
+        for (size_t w = 0; w < threads.size(); w++) {
+            threads[w].join();
+        }
+    }
+
+    int numWorkers() const { return (int)queues.size(); }
+
+    // From outside the pool: tasks are dealt round-robin
+    void submit(task_t task) {
+        int w = (int)(next_queue++ % queues.size());
+        push(w, task);
+    }
+
+    // From inside a task running on worker w: the task goes to w's own deque
+    void submitLocal(int w, task_t task) {
+        push(w, task);
+    }
+
+    // Block until every submitted task, including tasks they spawned, has run
+    void wait() {
+        std::unique_lock<std::mutex> lk(idle_lock);
+        done_cv.wait(lk, [this] { return pending.load() == 0; });
+    }
+
+    long stealCount(int w) const { return steals[w]; }
+    long taskCount(int w) const { return executed[w]; }
+
+private:
+    struct worker_queue {
+        std::mutex lock;
+        std::deque<task_t> tasks;
+    };
+
+    void push(int w, task_t& task) {
+        pending++;
+        {
+            std::lock_guard<std::mutex> lk(queues[w]->lock);
+            queues[w]->tasks.push_back(task);
+        }
+        queued++;
+        // Taking idle_lock orders the queued increment before any sleeping
+        // worker re-checks it, so the wakeup cannot be lost
+        {
+            std::lock_guard<std::mutex> lk(idle_lock);
+        }
+        idle_cv.notify_one();
+    }
+
+    bool popLocal(int w, task_t& task) {
+        std::lock_guard<std::mutex> lk(queues[w]->lock);
+        if (queues[w]->tasks.empty()) {
+            return false;
+        }
+        task = queues[w]->tasks.back();
+        queues[w]->tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int w, task_t& task) {
+        int n = (int)queues.size();
+        for (int i = 1; i < n; i++) {
+            int victim = (w + i) % n;
+            std::lock_guard<std::mutex> lk(queues[victim]->lock);
+            if (!queues[victim]->tasks.empty()) {
+                task = queues[victim]->tasks.front();
+                queues[victim]->tasks.pop_front();
+                steals[w]++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int w) {
+        while (true) {
+            task_t task;
+            if (popLocal(w, task) || steal(w, task)) {
+                queued--;
+                task(w);
+                executed[w]++;
+                if (--pending == 0) {
+                    std::lock_guard<std::mutex> lk(idle_lock);
+                    done_cv.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk(idle_lock);
+            idle_cv.wait(lk, [this] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<worker_queue> > queues;
+    std::vector<std::thread> threads;
+    std::vector<long> steals;
+    std::vector<long> executed;
+    std::atomic<long> queued;  // tasks sitting in a deque
+    std::atomic<long> pending; // tasks submitted and not yet finished
+    std::atomic<unsigned long> next_queue{0};
+    bool stopping;
+    std::mutex idle_lock;
+    std::condition_variable idle_cv;
+    std::condition_variable done_cv;
+};
+
+} // namespace model
+} // namespace detector
+
+#endif
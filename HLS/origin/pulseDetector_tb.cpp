@@ -1,4 +1,5 @@
 #include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -16,22 +17,17 @@ int main() {
     int location_ref;
     int i;
 
-    // Read RxSignal from file
-    ifstream rx_file("RxSignal_in.txt");
-    if (!rx_file.is_open()) {
-        cerr << "Error opening RxSignal_in.txt" << endl;
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
         return 1;
     }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        RxSignal.write(rx_capture.sample<complex_fixed_point>(i));
+    }
     string line;
     fixed_point real_part, imag_part;
-    i = 0;
-    while (getline(rx_file, line) && i < SIGNAL_LENGTH) {
-        stringstream ss(line);
-        ss >> real_part >> imag_part;
-        RxSignal.write(complex_fixed_point(real_part, imag_part));
-        i++;
-    }
-    rx_file.close();
 
     // Read CorrFilter from file
     ifstream corr_file("CorrFilter_in.txt");
@@ -1,29 +1,45 @@
 #ifndef PULSE_DETECTOR_HPP
 #define PULSE_DETECTOR_HPP
 
-#include <ap_fixed.h>
-#include <hls_stream.h>
+#include "../common/pulseDetectorCore.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps; a
+// FILTER_LENGTH above 64 zero-pads the compiled-in templates.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// direct complex multiply with the template loaded at run time and the
+// filter and peak search merged into one loop
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+typedef detector::direct_complex<detector_cfg> filter_arch;
 
 // Define fixed-point data types
-typedef ap_fixed<18, 2> fixed_point; // Example: 18-bit fixed-point with 2 integer bits
-typedef std::complex<fixed_point> complex_fixed_point;
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
 
 // Define float data types
 typedef float float_point;
 typedef std::complex<float_point> complex_float_point;
 
 // Define stream types
-typedef hls::stream<complex_fixed_point> complex_stream;
-typedef hls::stream<fixed_point> real_stream;
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
 typedef hls::stream<int> int_stream;
 
-// Define parameters (example) using macro definitions
-#define FILTER_LENGTH 64
-#define SIGNAL_LENGTH 5000
-
 // Function declarations
-void matchFilter(complex_stream& RxSignal, complex_stream& CorrFilter, real_stream& FilterOut);
-void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location);
 void pulseDetector(complex_stream& RxSignal, complex_stream& CorrFilter, fixed_point& peak, int& location);
 
 #endif
@@ -0,0 +1,22 @@
+#include "pulseDetector.hpp"
+
+// Waveform ROM: the three-real taps of every template, by waveform ID
+const fixed_point (&waveformRom)[NUM_WAVEFORMS][FILTER_LENGTH][3] = waveform_rom::value;
+
+void captureFrame(complex_stream& RxSignal, complex_fixed_point frameBuf[SIGNAL_LENGTH]) {
+    replay_arch::captureFrame(RxSignal, frameBuf);
+}
+
+void replayFrame(const complex_fixed_point frameBuf[SIGNAL_LENGTH], fixed_point& peak, int& location, int& waveform) {
+    replay_arch::replayFrame(frameBuf, waveformRom, peak, location, waveform);
+}
+
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location, int& waveform) {
+#pragma HLS DATAFLOW
+    // Ping-pong frame buffer: one frame is captured while the previous one is
+    // replayed
+    complex_fixed_point frameBuf[SIGNAL_LENGTH];
+
+    captureFrame(RxSignal, frameBuf);
+    replayFrame(frameBuf, peak, location, waveform);
+}
@@ -0,0 +1,61 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorReplay.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+// Templates in the waveform ROM. Each frame is replayed NUM_WAVEFORMS times,
+// so the clock must be at least NUM_WAVEFORMS times the sample rate
+#ifndef NUM_WAVEFORMS
+#define NUM_WAVEFORMS 4
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// one three-real correlator time-shared by NUM_WAVEFORMS templates
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+typedef detector::waveform_replay<detector_cfg, NUM_WAVEFORMS> replay_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Waveform ROM, built at compile time (pulseDetectorTaps.hpp): waveform 0 is
+// the template and 1 its conjugate, as the coefficient sets of
+// resource_opt4; the rest are pseudo-random QPSK codes
+typedef detector::coeff::waveform_taps<detector::recorded_template, NUM_WAVEFORMS, FILTER_LENGTH, fixed_point::width,
+                                       fixed_point::width - fixed_point::iwidth, 2024u> waveform_taps;
+typedef detector::coeff::bank_rom<fixed_point, waveform_taps> waveform_rom;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+
+// Function declarations
+void captureFrame(complex_stream& RxSignal, complex_fixed_point frameBuf[SIGNAL_LENGTH]);
+void replayFrame(const complex_fixed_point frameBuf[SIGNAL_LENGTH], fixed_point& peak, int& location, int& waveform);
+
+// Best peak over all templates and samples of the frame, and the waveform ID
+// of the template that gave it
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location, int& waveform);
+
+#endif
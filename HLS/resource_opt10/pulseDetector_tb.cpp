@@ -0,0 +1,160 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+
+// A separate correlator per template, the resource_opt3 datapath, is the
+// reference
+typedef detector::three_real_mult<detector_cfg> reference_arch;
+
+// Quiet frames holding one matched pulse of waveform w, ending at
+// PULSE_END + w * PULSE_STEP, spread over the frame for any NUM_WAVEFORMS
+const int PULSE_END = 1000;
+const int PULSE_STEP = (SIGNAL_LENGTH - PULSE_END) / NUM_WAVEFORMS;
+const double PULSE_GAIN = 8;
+const double IDLE_NOISE = 1.0 / 64;
+
+static void runReplay(const complex_fixed_point frame[SIGNAL_LENGTH], fixed_point& peak, int& location, int& waveform) {
+    complex_stream RxSignal;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    pulseDetector(RxSignal, peak, location, waveform);
+}
+
+// Peak of every template on its own correlator, and the best of them; the
+// lower waveform ID wins a tie
+static void runReference(const complex_fixed_point frame[SIGNAL_LENGTH], fixed_point peaks[NUM_WAVEFORMS], fixed_point& peak,
+                         int& location, int& waveform) {
+    peak = 0;
+    location = 0;
+    waveform = 0;
+    for (int w = 0; w < NUM_WAVEFORMS; w++) {
+        complex_stream RxSignal;
+        real_stream FilterOut;
+        int location_w;
+        for (int i = 0; i < SIGNAL_LENGTH; i++) {
+            RxSignal.write(frame[i]);
+        }
+        detector::matchFilter<detector_cfg, reference_arch>(RxSignal, waveform_rom::value[w], FilterOut);
+        detector::peakFinder<detector_cfg>(FilterOut, peaks[w], location_w);
+        if (peaks[w] > peak) {
+            peak = peaks[w];
+            location = location_w;
+            waveform = w;
+        }
+    }
+}
+
+int main() {
+    static complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw, waveform_hw;
+    fixed_point peak_ref;
+    int location_ref;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+    }
+    // Run the pulse detector
+    runReplay(rxSignalArray, peak_hw, location_hw, waveform_hw);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << ", Waveform: " << waveform_hw << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = location_hw + 1 == location_ref && waveform_hw == 0;
+
+    // The capture and one frame per waveform: the replay must give the best
+    // of the separate correlators bit for bit, and each synthetic pulse must
+    // be found with its own waveform
+    fixed_point peaks[NUM_WAVEFORMS];
+    fixed_point peak_sep;
+    int location_sep, waveform_sep;
+    runReference(rxSignalArray, peaks, peak_sep, location_sep, waveform_sep);
+    if (peak_hw != peak_sep || location_hw != location_sep || waveform_hw != waveform_sep) {
+        passed = false;
+    }
+
+    cout << "waveform  location  found  matched peak  best other (dB below)" << endl;
+    complex_fixed_point frame[SIGNAL_LENGTH];
+    for (int w = 0; w < NUM_WAVEFORMS; w++) {
+        int pulse_end = PULSE_END + w * PULSE_STEP;
+        unsigned state = 12345u;
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            double noise[2];
+            for (int c = 0; c < 2; c++) {
+                state = state * 1664525u + 1013904223u;
+                noise[c] = IDLE_NOISE * (((state >> 8) & 0xffff) / 32768.0 - 1);
+            }
+            int j = pulse_end - k;
+            if (j >= 0 && j < FILTER_LENGTH) {
+                noise[0] += PULSE_GAIN * waveform_taps::tap(w, j, 0);
+                noise[1] -= PULSE_GAIN * waveform_taps::tap(w, j, 1);
+            }
+            frame[k] = complex_fixed_point(noise[0], noise[1]);
+        }
+
+        fixed_point peak_w;
+        int location_w, waveform_w;
+        runReplay(frame, peak_w, location_w, waveform_w);
+        runReference(frame, peaks, peak_sep, location_sep, waveform_sep);
+        if (peak_w != peak_sep || location_w != location_sep || waveform_w != waveform_sep) {
+            passed = false;
+        }
+        if (waveform_w != w || location_w != pulse_end) {
+            passed = false;
+        }
+
+        fixed_point other = 0;
+        for (int v = 0; v < NUM_WAVEFORMS; v++) {
+            if (v != w && peaks[v] > other) {
+                other = peaks[v];
+            }
+        }
+        char row[96];
+        snprintf(row, sizeof(row), "%8d  %8d  %5d  %12.6f  %21.2f", w, location_w, waveform_w, peak_w.to_double(),
+                 10 * log10(peak_w.to_double() / other.to_double()));
+        cout << row << endl;
+    }
+
+    cout << "Replay: " << NUM_WAVEFORMS * SIGNAL_LENGTH << " cycles per frame (clock >= " << NUM_WAVEFORMS
+         << " x sample rate), " << 3 * FILTER_LENGTH << " multipliers instead of " << NUM_WAVEFORMS * 3 * FILTER_LENGTH << endl;
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
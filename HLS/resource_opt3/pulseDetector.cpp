@@ -1,72 +1,131 @@
 #include "pulseDetector.hpp"
-#include <cmath>
-#include <complex>
 
-const fixed_point corrFilterBuff[FILTER_LENGTH][3] = {
-#include "corrFilterArray.txt"
-};
+// The compiled-in template
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = template_rom::value;
+
+// Reload mode tap banks, bank 0 starts out with the compiled-in template
+static fixed_point (&tapBank)[2][FILTER_LENGTH][3] = detector::coeff::tap_banks<fixed_point, template_taps, 2>::value;
 
 void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
-    complex_fixed_point dataBuff[FILTER_LENGTH];
-#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+#if MATCH_FILTER_FORM == 2
+    systolic_arch::matchFilter(RxSignal, corrFilterBuff, FilterOut);
+#elif MATCH_FILTER_FORM == 1
+    transposed_arch::matchFilter(RxSignal, corrFilterBuff, FilterOut);
+#else
+    detector::matchFilter<detector_cfg, filter_arch>(RxSignal, corrFilterBuff, FilterOut);
+#endif
+}
 
-    for (int i = 0; i < FILTER_LENGTH; i++) {
-        dataBuff[i] = 0;
-    }
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
+    detector::peakFinder<detector_cfg>(FilterOut, peak, location);
+}
 
-    for (int i = 0; i < SIGNAL_LENGTH; i++) {
-#pragma HLS PIPELINE II=1
-        complex_fixed_point rx_sample = RxSignal.read();
-
-        // Shift the buffer
-        for (int j = FILTER_LENGTH - 1; j > 0; j--) {
-            dataBuff[j] = dataBuff[j - 1];
-        }
-        dataBuff[0] = rx_sample;
-
-        fixed_point conv_real = 0;
-        fixed_point conv_imag = 0;
-        fixed_point conv_plus = 0;
-
-        // Perform the filtering
-        for (int j = 0; j < FILTER_LENGTH; j++) {
-            conv_real += dataBuff[j].real() * corrFilterBuff[j][0];
-            conv_imag += dataBuff[j].imag() * corrFilterBuff[j][1];
-            conv_plus += (dataBuff[j].real() + dataBuff[j].imag()) * corrFilterBuff[j][2];
-        }
-
-        complex_fixed_point convSum;
-        convSum.real(conv_real - conv_plus);
-        convSum.imag(conv_imag + conv_plus);
-
-        fixed_point sum_mag_squared = convSum.real() * convSum.real() + convSum.imag() * convSum.imag();
-        FilterOut.write(sum_mag_squared); // Magnitude squared
-    }
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilter(RxSignal, FilterOut);
+    peakFinder(FilterOut, peak, location);
 }
 
-void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
-    fixed_point current_peak = 0;
-    int current_location = 0;
+void matchFilterStream(complex_stream& RxSignal, real_stream& FilterOut) {
+#if MATCH_FILTER_FORM != 0
+    transposed_arch::matchFilterStream(RxSignal, corrFilterBuff, FilterOut);
+#else
+    detector::matchFilterStream<detector_cfg, filter_arch>(RxSignal, corrFilterBuff, FilterOut);
+#endif
+}
 
-    for (int n = 0; n < SIGNAL_LENGTH; n++) {
-#pragma HLS PIPELINE II=1
-        fixed_point magVal = FilterOut.read();
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections) {
+    detector::peakFinderStream<detector_cfg>(FilterOut, Detections);
+}
 
-        if (magVal > current_peak) {
-            current_peak = magVal;
-            current_location = n;
-        }
-    }
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections) {
+#pragma HLS INTERFACE mode=ap_ctrl_none port=return
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
 
-    peak = current_peak;
-    location = current_location;
+    matchFilterStream(RxSignal, FilterOut);
+    peakFinderStream(FilterOut, Detections);
 }
 
-void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+void matchFilterReload(complex_stream& RxSignal, complex_stream& CoeffIn, real_stream& FilterOut) {
+    detector::matchFilterReload<detector_cfg, filter_arch>(RxSignal, CoeffIn, tapBank, FilterOut);
+}
+
+void pulseDetectorReload(complex_stream& RxSignal, complex_stream& CoeffIn, fixed_point& peak, int& location) {
 #pragma HLS DATAFLOW
     real_stream FilterOut;
 #pragma HLS STREAM variable=FilterOut depth=4 dim=1
+#pragma HLS STREAM variable=CoeffIn depth=FILTER_LENGTH
 
-    matchFilter(RxSignal, FilterOut);
+    matchFilterReload(RxSignal, CoeffIn, FilterOut);
     peakFinder(FilterOut, peak, location);
 }
+
+void matchFilterGated(complex_stream& RxSignal, energy_t threshold, real_stream& FilterOut) {
+    detector::matchFilterGated<detector_cfg, filter_arch>(RxSignal, corrFilterBuff, threshold, FilterOut);
+}
+
+void pulseDetectorGated(complex_stream& RxSignal, energy_t threshold, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilterGated(RxSignal, threshold, FilterOut);
+    peakFinder(FilterOut, peak, location);
+}
+
+void peakFinderEarly(real_stream& FilterOut, fixed_point threshold, early_stream& Early, fixed_point& peak, int& location) {
+    detector::peakFinderEarly<detector_cfg, EARLY_HOLDOFF>(FilterOut, threshold, Early, peak, location);
+}
+
+void pulseDetectorEarly(complex_stream& RxSignal, fixed_point threshold, early_stream& Early, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilter(RxSignal, FilterOut);
+    peakFinderEarly(FilterOut, threshold, Early, peak, location);
+}
+
+// Frame after frame through the selected correlator form; each call starts
+// from an empty delay line, as pulseDetector does
+static void filterFrames(complex_stream& RxSignal, int num_frames, real_stream& FilterOut) {
+    for (int f = 0; f < num_frames; f++) {
+        matchFilter(RxSignal, FilterOut);
+    }
+}
+
+static void peakFrames(real_stream& FilterOut, int num_frames, detection_stream& Detections) {
+    for (int f = 0; f < num_frames; f++) {
+        detection_t det;
+        peakFinder(FilterOut, det.peak, det.location);
+        det.frame = f;
+        Detections.write(det);
+    }
+}
+
+void pulseDetectorMM(const mm_beat_t* RxFrames, mm_record_t* Results, int num_frames) {
+#pragma HLS INTERFACE mode=m_axi port=RxFrames bundle=gmem0 offset=slave depth=MM_MAX_FRAMES*SIGNAL_LENGTH*64/MM_BEAT_WIDTH max_read_burst_length=256 num_read_outstanding=16
+#pragma HLS INTERFACE mode=m_axi port=Results bundle=gmem1 offset=slave depth=MM_MAX_FRAMES
+#pragma HLS INTERFACE mode=s_axilite port=num_frames
+#pragma HLS INTERFACE mode=s_axilite port=return
+#pragma HLS DATAFLOW
+    hls::stream<mm_beat_t> Beats;
+    complex_stream RxSignal;
+    real_stream FilterOut;
+    detection_stream Detections;
+#pragma HLS STREAM variable=Beats depth=512
+#pragma HLS STREAM variable=RxSignal depth=4
+#pragma HLS STREAM variable=FilterOut depth=4
+#pragma HLS STREAM variable=Detections depth=2
+
+    mm_frames::readBeats(RxFrames, num_frames, Beats);
+    mm_frames::unpack(Beats, num_frames, RxSignal);
+    filterFrames(RxSignal, num_frames, FilterOut);
+    peakFrames(FilterOut, num_frames, Detections);
+    mm_frames::writeRecords(Detections, num_frames, Results);
+}
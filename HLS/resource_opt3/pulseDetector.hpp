@@ -1,32 +1,119 @@
 #ifndef PULSE_DETECTOR_HPP
 #define PULSE_DETECTOR_HPP
 
-#include <ap_fixed.h>
-#include <hls_stream.h>
+#include "../common/pulseDetectorCore.hpp"
+#include "../common/pulseDetectorAxi.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps; a
+// FILTER_LENGTH above 64 zero-pads the compiled-in templates.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+// Correlator form of matchFilter and matchFilterStream:
+//   0  direct, an adder chain over the whole delay line per output
+//   1  transposed, one registered partial sum per tap
+//   2  systolic, DSP48 cascade structure, FILTER_LENGTH cycles of extra
+//      latency; matchFilterStream uses the transposed form, since the latency
+//      would move outputs across frame boundaries
+#ifndef MATCH_FILTER_FORM
+#define MATCH_FILTER_FORM 0
+#endif
+// Early-report mode: samples a local maximum must stay unbeaten before it is
+// reported
+#ifndef EARLY_HOLDOFF
+#define EARLY_HOLDOFF 16
+#endif
+// Memory-mapped mode: m_axi data width in bits (a multiple of 64, one sample
+// per 64 bits), and the largest frame count cosimulation sizes the DDR for
+#ifndef MM_BEAT_WIDTH
+#define MM_BEAT_WIDTH 128
+#endif
+#ifndef MM_MAX_FRAMES
+#define MM_MAX_FRAMES 16
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// three real filters with the template compiled in (pulseDetectorTemplate.hpp)
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+typedef detector::three_real_mult<detector_cfg> filter_arch;
+typedef detector::three_real_transposed<detector_cfg> transposed_arch;
+typedef detector::three_real_systolic<detector_cfg> systolic_arch;
 
 // Define fixed-point data types
-typedef ap_fixed<18, 2> fixed_point; // Example: 16-bit fixed-point with 8 integer bits
-typedef std::complex<fixed_point> complex_fixed_point;
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
 
 // Define float data types
 typedef float float_point;
 typedef std::complex<float_point> complex_float_point;
 
 // Define stream types
-typedef hls::stream<complex_fixed_point> complex_stream;
-typedef hls::stream<fixed_point> real_stream;
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
 typedef hls::stream<int> int_stream;
 
-// Define parameters (example) using macro definitions
-#define FILTER_LENGTH 64
-#define SIGNAL_LENGTH 5000
+// Per-frame detection record emitted by the continuous (free-running) mode
+typedef detector_cfg::detection_t detection_t;
+typedef detector_cfg::detection_stream detection_stream;
+
+// Early-report record; a record with last set (location -1) closes the frame
+typedef detector_cfg::early_detection_t early_detection_t;
+typedef detector_cfg::early_stream early_stream;
+
+// Sliding-window input energy compared against the gate threshold
+typedef detector::energy_gate<detector_cfg>::energy_t energy_t;
+
+// DDR frame buffer beats and result records of the memory-mapped mode
+typedef detector::axi_frames<detector_cfg, MM_BEAT_WIDTH> mm_frames;
+typedef mm_frames::beat_t mm_beat_t;
+typedef mm_frames::record_t mm_record_t;
 
-// Define constant array
-//const fixed_point corrFilterBuff[FILTER_LENGTH][3] = { /* Initialize with appropriate values */ };
+// Compiled-in template: the recorded pulse split into the three-real form at
+// compile time, and its ROM
+typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+typedef detector::coeff::tap_rom<fixed_point, template_taps> template_rom;
 
 // Function declarations
 void matchFilter(complex_stream& RxSignal, real_stream& FilterOut);
 void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location);
 void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location);
 
+// Continuous mode: filter state persists across frames, one record per frame
+void matchFilterStream(complex_stream& RxSignal, real_stream& FilterOut);
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections);
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections);
+
+// Reload mode: taps persist across calls; a set written to CoeffIn is loaded
+// without stalling the samples and takes effect from the following frame
+void matchFilterReload(complex_stream& RxSignal, complex_stream& CoeffIn, real_stream& FilterOut);
+void pulseDetectorReload(complex_stream& RxSignal, complex_stream& CoeffIn, fixed_point& peak, int& location);
+
+// Energy-gated mode: while the energy of the last FILTER_LENGTH samples is
+// below threshold the multipliers are idle and the filter outputs 0
+void matchFilterGated(complex_stream& RxSignal, energy_t threshold, real_stream& FilterOut);
+void pulseDetectorGated(complex_stream& RxSignal, energy_t threshold, fixed_point& peak, int& location);
+
+// Early-report mode: every local maximum at or above threshold is written to
+// Early EARLY_HOLDOFF samples after it, alongside the end-of-frame peak
+void peakFinderEarly(real_stream& FilterOut, fixed_point threshold, early_stream& Early, fixed_point& peak, int& location);
+void pulseDetectorEarly(complex_stream& RxSignal, fixed_point threshold, early_stream& Early, fixed_point& peak, int& location);
+
+// Memory-mapped mode: num_frames frames are burst-read from RxFrames (the
+// payload of a .iq capture, frame after frame) and one record per frame is
+// written to Results
+void pulseDetectorMM(const mm_beat_t* RxFrames, mm_record_t* Results, int num_frames);
+
 #endif
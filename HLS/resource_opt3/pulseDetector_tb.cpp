@@ -1,4 +1,5 @@
 #include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -10,66 +11,51 @@ int main() {
     complex_stream RxSignal;
     // complex_stream CorrFilter;
     complex_fixed_point corrFilterArray[FILTER_LENGTH];
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
     fixed_point peak_hw;
     int location_hw;
     fixed_point peak_ref;
     int location_ref;
     int i;
 
-    // Read RxSignal from file
-    ifstream rx_file("RxSignal_in.txt");
-    if (!rx_file.is_open()) {
-        cerr << "Error opening RxSignal_in.txt" << endl;
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
         return 1;
     }
-    string line;
-    fixed_point real_part, imag_part;
-    i = 0;
-    while (getline(rx_file, line) && i < SIGNAL_LENGTH) {
-        stringstream ss(line);
-        ss >> real_part >> imag_part;
-        RxSignal.write(complex_fixed_point(real_part, imag_part));
-        i++;
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        RxSignal.write(rxSignalArray[i]);
+    }
+    // The compiled-in template, quantised to the tap word as the constexpr
+    // transform does
+    for (int k = 0; k < FILTER_LENGTH; k++) {
+        if (k < detector::recorded_template::length) {
+            corrFilterArray[k] = complex_fixed_point(detector::recorded_template::value(k, 0), detector::recorded_template::value(k, 1));
+        } else {
+            corrFilterArray[k] = 0;
+        }
     }
-    rx_file.close();
 
-    // Read CorrFilter from file
+    // The template header must be the MATLAB template; every variant with
+    // compiled-in taps (resource_opt3-10, throughput_opt1) derives its tables
+    // from that header, so this is the only check against the file
     ifstream corr_file("CorrFilter_in.txt");
     if (!corr_file.is_open()) {
         cerr << "Error opening CorrFilter_in.txt" << endl;
         return 1;
     }
-
-    i = 0;
-    while (getline(corr_file, line) && i < FILTER_LENGTH) {
-        stringstream ss(line);
-        ss >> real_part >> imag_part;
-        corrFilterArray[i] = complex_fixed_point(real_part, imag_part);
-        i++;
-    }
-    corr_file.close();
-
-    // Print corrFilterArray to file
-    ofstream init_file("corrFilterArray.txt");
-    if (!init_file.is_open()) {
-        cerr << "Error opening corrFilterArray.txt" << endl;
-        return 1;
-    }
-    //init_file << "{" << endl;
-    for (int k = 0; k < FILTER_LENGTH; k++) {
-        fixed_point val1 = corrFilterArray[k].real() + corrFilterArray[k].imag();
-        fixed_point val2 = corrFilterArray[k].real() - corrFilterArray[k].imag();
-        fixed_point val3 = corrFilterArray[k].imag();
-
-        init_file << "{" << val1 << ", " << val2 << ", " << val3 << "}";
-        if (k < FILTER_LENGTH - 1) {
-            init_file << "," << endl;
-        } else {
-            init_file << endl;
+    int template_mismatches = 0;
+    for (int k = 0; k < detector::recorded_template::length; k++) {
+        double real_part, imag_part;
+        if (!(corr_file >> real_part >> imag_part) || real_part != detector::recorded_template::value(k, 0) ||
+            imag_part != detector::recorded_template::value(k, 1)) {
+            template_mismatches++;
         }
     }
-    //init_file << "}";
-    init_file.close();
+    corr_file.close();
+    cout << "Template header mismatches against CorrFilter_in.txt: " << template_mismatches << endl;
 
     // Run the pulse detector
     pulseDetector(RxSignal, peak_hw, location_hw);
@@ -96,7 +82,301 @@ int main() {
     cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
     cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
 
-    if (location_hw + 1 == location_ref) {
+    bool passed = (location_hw + 1 == location_ref) && template_mismatches == 0;
+
+    // Correlator forms: every output word of the transposed and systolic
+    // filters must match the direct form
+    {
+        const fixed_point (&taps)[FILTER_LENGTH][3] = template_rom::value;
+        complex_stream RxDirect, RxTransposed, RxSystolic;
+        real_stream OutDirect, OutTransposed, OutSystolic;
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxDirect.write(rxSignalArray[k]);
+            RxTransposed.write(rxSignalArray[k]);
+            RxSystolic.write(rxSignalArray[k]);
+        }
+        detector::matchFilter<detector_cfg, filter_arch>(RxDirect, taps, OutDirect);
+        transposed_arch::matchFilter(RxTransposed, taps, OutTransposed);
+        systolic_arch::matchFilter(RxSystolic, taps, OutSystolic);
+
+        int transposed_mismatches = 0;
+        int systolic_mismatches = 0;
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            fixed_point direct = OutDirect.read();
+            transposed_mismatches += OutTransposed.read() != direct;
+            systolic_mismatches += OutSystolic.read() != direct;
+        }
+        cout << "Correlator form: " << MATCH_FILTER_FORM << ", transposed mismatches: " << transposed_mismatches
+             << ", systolic mismatches: " << systolic_mismatches << " (latency " << systolic_arch::latency << ")" << endl;
+        if (transposed_mismatches != 0 || systolic_mismatches != 0 || !OutSystolic.empty()) {
+            passed = false;
+        }
+    }
+
+    // Continuous mode: rotate the signal so that the pulse straddles the frame
+    // boundary and feed it as back-to-back frames. Every frame after the first
+    // sees the tail of its predecessor in the delay line, so it must report the
+    // same peak as the single-frame run.
+    const int NUM_STREAM_FRAMES = 3;
+    const int STREAM_OFFSET = location_hw - FILTER_LENGTH / 2;
+    complex_stream RxStream;
+    detection_stream Detections;
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxStream.write(rxSignalArray[(k + STREAM_OFFSET) % SIGNAL_LENGTH]);
+        }
+        pulseDetectorStream(RxStream, Detections);
+    }
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        detection_t det = Detections.read();
+        cout << "Stream Frame: " << det.frame << ", Peak: " << det.peak << ", Location: " << det.location << endl;
+        if (det.frame != f) {
+            passed = false;
+        }
+        if (f > 0 && (det.location != location_hw - STREAM_OFFSET || det.peak != peak_hw)) {
+            passed = false;
+        }
+    }
+
+    // Reload mode: a set written during frame k is swapped in at frame k+1.
+    // Load the conjugate template, run, then restore the original one.
+    complex_stream CoeffIn;
+    fixed_point peak_reload[4];
+    int location_reload[4];
+    for (int f = 0; f < 4; f++) {
+        if (f == 0 || f == 2) {
+            for (int k = 0; k < FILTER_LENGTH; k++) {
+                complex_fixed_point tap = corrFilterArray[k];
+                CoeffIn.write(f == 0 ? complex_fixed_point(tap.real(), -tap.imag()) : tap);
+            }
+        }
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxSignal.write(rxSignalArray[k]);
+        }
+        pulseDetectorReload(RxSignal, CoeffIn, peak_reload[f], location_reload[f]);
+        cout << "Reload Frame: " << f << ", Peak: " << peak_reload[f] << ", Location: " << location_reload[f] << endl;
+    }
+    // The reloaded template is converted by the kernel and the compiled-in
+    // one at compile time; both must give the same taps, so the same peak
+    if (peak_reload[0] != peak_hw || location_reload[0] != location_hw ||
+        location_reload[1] == location_hw || peak_reload[2] != peak_reload[1] ||
+        peak_reload[3] != peak_hw || location_reload[3] != location_hw) {
+        passed = false;
+    }
+
+    // Energy gate. With threshold 0 nothing is gated and every output must
+    // match matchFilter.
+    real_stream FilterFull, FilterGated;
+    fixed_point mag_full[SIGNAL_LENGTH];
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(rxSignalArray[k]);
+    }
+    matchFilter(RxSignal, FilterFull);
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(rxSignalArray[k]);
+        mag_full[k] = FilterFull.read();
+    }
+    matchFilterGated(RxSignal, 0, FilterGated);
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        if (FilterGated.read() != mag_full[k]) {
+            passed = false;
+        }
+    }
+
+    // A mostly idle frame: low noise and one matched pulse, x[n0 - j] =
+    // A conj(t[j]), so the peak is (A Et)^2 with Et the template energy. The
+    // gate is set for a minimum detectable magnitude of a quarter of that.
+    const int PULSE_END = 2500;
+    const double PULSE_GAIN = 8;
+    const double IDLE_NOISE = 1.0 / 64;
+    double template_energy = 0;
+    for (int k = 0; k < FILTER_LENGTH; k++) {
+        template_energy += norm(complex<double>(corrFilterArray[k].real().to_double(), corrFilterArray[k].imag().to_double()));
+    }
+    double min_detectable = 0.25 * (PULSE_GAIN * template_energy) * (PULSE_GAIN * template_energy);
+    energy_t gate_threshold = min_detectable / template_energy;
+
+    complex_fixed_point idleArray[SIGNAL_LENGTH];
+    unsigned state = 12345u;
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        double noise[2];
+        for (int c = 0; c < 2; c++) {
+            state = state * 1664525u + 1013904223u;
+            noise[c] = IDLE_NOISE * (((state >> 8) & 0xffff) / 32768.0 - 1);
+        }
+        int j = PULSE_END - k;
+        if (j >= 0 && j < FILTER_LENGTH) {
+            noise[0] += PULSE_GAIN * corrFilterArray[j].real().to_double();
+            noise[1] -= PULSE_GAIN * corrFilterArray[j].imag().to_double();
+        }
+        idleArray[k] = complex_fixed_point(noise[0], noise[1]);
+    }
+
+    // Gated outputs are 0 and were below the bound; the rest are exact
+    detector::gate_counter::instance() = detector::gate_counter();
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(idleArray[k]);
+    }
+    matchFilter(RxSignal, FilterFull);
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(idleArray[k]);
+        mag_full[k] = FilterFull.read();
+    }
+    matchFilterGated(RxSignal, gate_threshold, FilterGated);
+    int gated_outputs = 0;
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        fixed_point mag_gated = FilterGated.read();
+        if (mag_gated != mag_full[k]) {
+            gated_outputs++;
+            if (mag_gated != 0 || mag_full[k].to_double() > min_detectable + 1.0 / 4096) {
+                passed = false;
+            }
+        }
+    }
+    detector::gate_counter gate = detector::gate_counter::instance();
+
+    fixed_point peak_idle, peak_gated;
+    int location_idle, location_gated;
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(idleArray[k]);
+    }
+    pulseDetector(RxSignal, peak_idle, location_idle);
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(idleArray[k]);
+    }
+    pulseDetectorGated(RxSignal, gate_threshold, peak_gated, location_gated);
+    cout << "Gated Peak: " << peak_gated << ", Location: " << location_gated << ", gated cycles: " << 100 * gate.gatedFraction()
+         << "% (" << gated_outputs << " outputs changed)" << endl;
+    if (peak_gated != peak_idle || location_gated != location_idle || location_idle != PULSE_END || gate.gated == 0) {
+        passed = false;
+    }
+
+    // The recorded capture is noise-limited: its window energy stays far
+    // above a threshold that keeps its peak, so little is gated there
+    detector::gate_counter::instance() = detector::gate_counter();
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(rxSignalArray[k]);
+    }
+    pulseDetectorGated(RxSignal, peak_hw.to_double() / 4 / template_energy, peak_gated, location_gated);
+    cout << "Recorded capture gated cycles: " << 100 * detector::gate_counter::instance().gatedFraction() << "%" << endl;
+    if (peak_gated != peak_hw || location_gated != location_hw) {
+        passed = false;
+    }
+
+    // Early reports, on the recorded capture and on the quiet frame with the
+    // threshold at a quarter of the peak: every record is a local maximum at
+    // or above the threshold, reported
+    // EARLY_HOLDOFF samples after it; the summary is that of pulseDetector,
+    // and the global peak is among the records
+    for (int c = 0; c < 2; c++) {
+        const complex_fixed_point* frame = c == 0 ? rxSignalArray : idleArray;
+        fixed_point peak_frame, peak_early, threshold;
+        int location_frame, location_early;
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxSignal.write(frame[k]);
+        }
+        matchFilter(RxSignal, FilterFull);
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            mag_full[k] = FilterFull.read();
+            RxSignal.write(frame[k]);
+        }
+        pulseDetector(RxSignal, peak_frame, location_frame);
+        threshold = peak_frame.to_double() / 4;
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxSignal.write(frame[k]);
+        }
+        early_stream Early;
+        pulseDetectorEarly(RxSignal, threshold, Early, peak_early, location_early);
+
+        bool peak_reported = false;
+        int num_early = 0;
+        for (early_detection_t det = Early.read(); !det.last; det = Early.read()) {
+            int latency = det.timestamp - det.location;
+            cout << "Early Detection: " << det.peak << ", Location: " << det.location << ", reported at " << det.timestamp
+                 << " (latency " << latency << " samples, end of frame " << SIGNAL_LENGTH - 1 - det.location << ")" << endl;
+            if (det.peak != mag_full[det.location] || det.peak < threshold
+                || (det.location > 0 && mag_full[det.location - 1] >= det.peak)
+                || (latency != EARLY_HOLDOFF && det.timestamp != SIGNAL_LENGTH - 1)) {
+                passed = false;
+            }
+            for (int k = det.location + 1; k <= det.timestamp; k++) {
+                if (mag_full[k] > det.peak) {
+                    passed = false;
+                }
+            }
+            if (det.location == location_frame) {
+                peak_reported = true;
+            }
+            num_early++;
+        }
+        cout << "Early Detections: " << num_early << endl;
+        if (!peak_reported || peak_early != peak_frame || location_early != location_frame) {
+            passed = false;
+        }
+    }
+
+    // Memory-mapped mode: rotated copies of the capture, packed into beats
+    // straight from its words as they would sit in DDR, must give the records
+    // of pulseDetector on the same frames
+    const int MM_FRAMES = 4;
+    static mm_beat_t mm_frame_buffer[MM_FRAMES * mm_frames::beats_per_frame];
+    mm_record_t mm_results[MM_FRAMES];
+    const int32_t* rx_words = rx_capture.data();
+    for (int f = 0; f < MM_FRAMES; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            int n = (k + 1237 * f) % SIGNAL_LENGTH;
+            int lane = k % mm_frames::samples_per_beat;
+            mm_beat_t& beat = mm_frame_buffer[f * mm_frames::beats_per_frame + k / mm_frames::samples_per_beat];
+            beat.range(64 * lane + 31, 64 * lane) = (uint32_t)rx_words[2 * n];
+            beat.range(64 * lane + 63, 64 * lane + 32) = (uint32_t)rx_words[2 * n + 1];
+        }
+    }
+    pulseDetectorMM(mm_frame_buffer, mm_results, MM_FRAMES);
+    for (int f = 0; f < MM_FRAMES; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxSignal.write(rxSignalArray[(k + 1237 * f) % SIGNAL_LENGTH]);
+        }
+        fixed_point peak_frame;
+        int location_frame;
+        pulseDetector(RxSignal, peak_frame, location_frame);
+        int32_t peak_word = (int32_t)(uint32_t)mm_results[f].range(31, 0);
+        int location_mm = (int)mm_results[f].range(63, 32);
+        cout << "MM frame " << f << " Peak: " << detector::iqValue(peak_word) << ", Location: " << location_mm << endl;
+        if (peak_word != detector::iqWord(peak_frame.to_double()) || location_mm != location_frame) {
+            passed = false;
+        }
+    }
+
+#if DETECTOR_PROBES_ENABLED
+    // ap_fixed<18,2> has headroom for this capture: no node may wrap
+    const detector::probe::registry& probes = detector::probe::registry::instance();
+    for (int n = 0; n < probes.numNodes(); n++) {
+        if (probes[n].wraps != 0) {
+            cout << "Node " << probes[n].name << " wrapped " << probes[n].wraps << " times" << endl;
+            passed = false;
+        }
+    }
+    if (probes.find("conv_plus") == NULL || probes.find("mag") == NULL || probes.numFrames() == 0) {
+        passed = false;
+    }
+
+    // A sum through +3 that ends at -0.25 is a transient; a value of 2.5 wraps
+    DETECTOR_PROBE_SUM(probe_check);
+    DETECTOR_PROBE_ADD(probe_check, fixed_point, fixed_point(1.5));
+    DETECTOR_PROBE_ADD(probe_check, fixed_point, fixed_point(1.5));
+    DETECTOR_PROBE_ADD(probe_check, fixed_point, fixed_point(-1.5));
+    DETECTOR_PROBE_ADD(probe_check, fixed_point, fixed_point(-1.75));
+    DETECTOR_PROBE_END(probe_check, fixed_point);
+    DETECTOR_PROBE_VALUE(probe_check, fixed_point, 2.5);
+    const detector::probe::node_stats* check = probes.find("probe_check");
+    if (check == NULL || check->transients != 1 || check->wraps != 1) {
+        passed = false;
+    }
+#endif
+
+    if (passed) {
         cout << "Test passed!" << endl;
         return 0;
     } else {
@@ -7,6 +7,8 @@ set COSIM 1
 set VIVADO_SYN 1
 set VIVADO_IMPL 1
 set SOLN "solution1"
+# 1 compiles the overflow probes (pulseDetectorProbe.hpp) into csim; synthesis ignores them
+set PROBES 0
 
 # setup hardware
 set CLKP 300MHz
@@ -21,16 +23,27 @@ puts "PROJ=${PROJ}"
 
 #edit the below line to match project
 set basename "pulseDetector"
+# top function: ${basename} (single frame), ${basename}Stream (continuous mode),
+# ${basename}Reload (runtime coefficient reload), ${basename}Gated (energy gate),
+# ${basename}Early (early detection reports) or ${basename}MM (frames burst-read
+# from DDR over m_axi)
+set TOP ${basename}
 
 open_project -reset proj_${basename}
-set_top ${basename}
+set_top ${TOP}
+
+# the tap tables are constexpr code (pulseDetectorTaps.hpp)
+set CFLAGS "-std=c++14"
+if {$PROBES == 1} {
+  append CFLAGS " -DDETECTOR_PROBES"
+}
 
 #add_files ${basename}.cpp -cflags "${INCL}"
-add_files ${basename}.cpp
+add_files ${basename}.cpp -cflags "${CFLAGS}"
 
 
 #add_files -tb ${basename}_tb.cpp  -cflags "${INCL_TB}"
-add_files -tb ${basename}_tb.cpp
+add_files -tb ${basename}_tb.cpp -cflags "${CFLAGS}"
 add_files -tb RxSignal_in.txt
 add_files -tb CorrFilter_in.txt
 add_files -tb peak_out.txt
@@ -1,154 +1,69 @@
 #include "pulseDetector.hpp"
-#include <cmath>
-#include <complex>
 
-// Static parameters for the FIR filter IP
-struct config1 : hls::ip_fir::params_t {
-    static const unsigned num_channels = 1;
-    static const unsigned total_num_coeff = FILTER_LENGTH;
-    static const double coeff_vec[total_num_coeff];
-    static const unsigned input_width = INPUT_WIDTH;
-    static const unsigned input_fractional_bits = INPUT_FRACTIONAL_BITS;
-    static const unsigned output_width = OUTPUT_WIDTH;
-    static const unsigned output_fractional_bits = OUTPUT_FRACTIONAL_BITS;
-    static const unsigned coeff_width = COEFF_WIDTH;
-    static const unsigned coeff_fractional_bits = COEFF_FRACTIONAL_BITS;
-    static const unsigned input_length = INPUT_LENGTH;
-    static const unsigned output_length = OUTPUT_LENGTH;
-    static const unsigned num_coeffs = COEFF_NUM;
-    static const unsigned coeff_sets = COEFF_SETS;
-    static const unsigned quantization = 1;
-    static const unsigned rate_specification = 0;
-    static const unsigned hardware_oversampling_rate = 1;
-    static const unsigned sample_period = SAMPLE_PERIOD;
-    static const unsigned sample_frequency = SAMPLE_FREQUENCY;
-};
-const double config1::coeff_vec[FILTER_LENGTH] = {
-#include "coeff1.txt"
-};
-
-struct config2 : hls::ip_fir::params_t {
-    static const unsigned num_channels = 1;
-    static const unsigned total_num_coeff = FILTER_LENGTH;
-    static const double coeff_vec[total_num_coeff];
-    static const unsigned input_width = INPUT_WIDTH;
-    static const unsigned input_fractional_bits = INPUT_FRACTIONAL_BITS;
-    static const unsigned output_width = OUTPUT_WIDTH;
-    static const unsigned output_fractional_bits = OUTPUT_FRACTIONAL_BITS;
-    static const unsigned coeff_width = COEFF_WIDTH;
-    static const unsigned coeff_fractional_bits = COEFF_FRACTIONAL_BITS;
-    static const unsigned input_length = INPUT_LENGTH;
-    static const unsigned output_length = OUTPUT_LENGTH;
-    static const unsigned num_coeffs = COEFF_NUM;
-    static const unsigned coeff_sets = COEFF_SETS;
-    static const unsigned quantization = 1;
-    static const unsigned rate_specification = 0;
-    static const unsigned hardware_oversampling_rate = 1;
-    static const unsigned sample_period = SAMPLE_PERIOD;
-    static const unsigned sample_frequency = SAMPLE_FREQUENCY;
-};
-const double config2::coeff_vec[FILTER_LENGTH] = {
-#include "coeff2.txt"
-};
-
-struct config3 : hls::ip_fir::params_t {
-    static const unsigned num_channels = 1;
-    static const unsigned total_num_coeff = FILTER_LENGTH;
-    static const double coeff_vec[total_num_coeff];
-    static const unsigned input_width = INPUT_WIDTH;
-    static const unsigned input_fractional_bits = INPUT_FRACTIONAL_BITS;
-    static const unsigned output_width = OUTPUT_WIDTH;
-    static const unsigned output_fractional_bits = OUTPUT_FRACTIONAL_BITS;
-    static const unsigned coeff_width = COEFF_WIDTH;
-    static const unsigned coeff_fractional_bits = COEFF_FRACTIONAL_BITS;
-    static const unsigned input_length = INPUT_LENGTH;
-    static const unsigned output_length = OUTPUT_LENGTH;
-    static const unsigned num_coeffs = COEFF_NUM;
-    static const unsigned coeff_sets = COEFF_SETS;
-    static const unsigned quantization = 1;
-    static const unsigned rate_specification = 0;
-    static const unsigned hardware_oversampling_rate = 1;
-    static const unsigned sample_period = SAMPLE_PERIOD;
-    static const unsigned sample_frequency = SAMPLE_FREQUENCY;
-};
-const double config3::coeff_vec[FILTER_LENGTH] = {
-#include "coeff3.txt"
-};
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+    filter_arch::matchFilter(RxSignal, FilterOut);
+}
 
-template<typename data_t, int LENGTH>
-void process_fe(complex_stream &in, hls::stream<data_t> &out1, hls::stream<data_t> &out2, hls::stream<data_t> &out3) {
+void matchFilter(complex_stream& RxSignal, config_t coeff_set, real_stream& FilterOut) {
+    select_arch::matchFilter(RxSignal, coeff_set, FilterOut);
+}
 
-    for(unsigned i = 0; i < LENGTH; i++) {
-#pragma HLS PIPELINE II=1 rewind=true
-        std::complex<data_t> val = in.read();
-        out1.write(val.real());
-        out2.write(val.imag());
-        out3.write(val.real() + val.imag());
-    }
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
+    detector::peakFinder<detector_cfg>(FilterOut, peak, location);
 }
 
-template<typename data_t, int LENGTH>
-void process_be(hls::stream<m_data_t> &in1, hls::stream<m_data_t> &in2, hls::stream<m_data_t> &in3, real_stream &out) {
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
 
-    for(unsigned i = 0; i < LENGTH; ++i) {
-#pragma HLS PIPELINE II=1 rewind=true
+    matchFilter(RxSignal, FilterOut);
+    peakFinder(FilterOut, peak, location);
+}
 
-        data_t val1 = in1.read();
-        data_t val2 = in2.read();
-        data_t val3 = in3.read();
-        data_t real = val1 - val3;
-        data_t imag = val2 + val3;
-        out.write(real * real + imag * imag);
-    }
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections) {
+    detector::peakFinderStream<detector_cfg>(FilterOut, Detections);
 }
 
-void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+void pulseDetectorSelect(complex_stream& RxSignal, config_t coeff_set, fixed_point& peak, int& location) {
 #pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
 
-    // Create FIR instances
-    static hls::FIR<config1> fir1;
-    static hls::FIR<config2> fir2;
-    static hls::FIR<config3> fir3;
-
-    hls::stream<s_data_t> fe1_out, fe2_out, fe3_out;
-#pragma HLS STREAM variable=fe1_out depth=2
-#pragma HLS STREAM variable=fe2_out depth=2
-#pragma HLS STREAM variable=fe3_out depth=2
-    hls::stream<m_data_t> be1_out, be2_out, be3_out;
-#pragma HLS STREAM variable=be1_out depth=2
-#pragma HLS STREAM variable=be2_out depth=2
-#pragma HLS STREAM variable=be3_out depth=2
-
-    process_fe<s_data_t, SIGNAL_LENGTH>(RxSignal, fe1_out, fe2_out, fe3_out);
-    fir1.run(fe1_out, be1_out);
-    fir2.run(fe2_out, be2_out);
-    fir3.run(fe3_out, be3_out);
-    process_be<fixed_point, SIGNAL_LENGTH>(be1_out, be2_out, be3_out, FilterOut);
+    matchFilter(RxSignal, coeff_set, FilterOut);
+    peakFinder(FilterOut, peak, location);
 }
 
-void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
-    fixed_point current_peak = 0;
-    int current_location = 0;
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections) {
+#pragma HLS INTERFACE mode=ap_ctrl_none port=return
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
 
-    for (int n = 0; n < SIGNAL_LENGTH; n++) {
-#pragma HLS PIPELINE II=1
-        fixed_point magVal = FilterOut.read();
+    // The FIR IP instances in matchFilter are static and the front/back-end
+    // loops rewind, so the delay lines carry over from frame to frame
+    matchFilter(RxSignal, FilterOut);
+    peakFinderStream(FilterOut, Detections);
+}
 
-        if (magVal > current_peak) {
-            current_peak = magVal;
-            current_location = n;
-        }
-    }
+void pulseDetectorTopK(complex_stream& RxSignal, peak_stream& Peaks) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
 
-    peak = current_peak;
-    location = current_location;
+    matchFilter(RxSignal, FilterOut);
+    detector::peakFinderTopK<detector_cfg, TOPK_NUM_PEAKS, TOPK_MIN_SEPARATION>(FilterOut, Peaks);
 }
 
-void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+void pulseDetectorCFAR(complex_stream& RxSignal, fixed_point& peak, int& location, cfar_stream& Detections) {
 #pragma HLS DATAFLOW
-    real_stream FilterOut;
+    real_stream FilterOut, PeakIn, CfarIn;
 #pragma HLS STREAM variable=FilterOut depth=4 dim=1
+#pragma HLS STREAM variable=PeakIn depth=4 dim=1
+#pragma HLS STREAM variable=CfarIn depth=4 dim=1
 
     matchFilter(RxSignal, FilterOut);
-    peakFinder(FilterOut, peak, location);
+    detector::duplicate<fixed_point, SIGNAL_LENGTH>(FilterOut, PeakIn, CfarIn);
+    peakFinder(PeakIn, peak, location);
+    detector::cfarDetector<detector_cfg, CFAR_GUARD, CFAR_TRAIN, CFAR_SCALE_NUM, CFAR_SCALE_DEN, cfar_sum_t>(CfarIn, Detections);
 }
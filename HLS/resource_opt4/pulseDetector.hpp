@@ -1,26 +1,79 @@
 #ifndef PULSE_DETECTOR_HPP
 #define PULSE_DETECTOR_HPP
 
-#include <ap_fixed.h>
-#include <hls_stream.h>
-#include <hls_fir.h> // Include FIR IP header
+#include "../common/pulseDetectorFirIp.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps; a
+// FILTER_LENGTH above 64 zero-pads the compiled-in templates.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// three real filters mapped onto FIR IP cores (fir_settings below)
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
 
 // Define fixed-point data types
-typedef ap_fixed<18, 2> fixed_point; // Example: 16-bit fixed-point with 8 integer bits
-typedef std::complex<fixed_point> complex_fixed_point;
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
 
 // Define float data types
 typedef float float_point;
 typedef std::complex<float_point> complex_float_point;
 
 // Define stream types
-typedef hls::stream<complex_fixed_point> complex_stream;
-typedef hls::stream<fixed_point> real_stream;
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
 typedef hls::stream<int> int_stream;
 
-// Define parameters (example) using macro definitions
-#define FILTER_LENGTH 64
-#define SIGNAL_LENGTH 5000
+// Per-frame detection record emitted by the continuous (free-running) mode
+typedef detector_cfg::detection_t detection_t;
+typedef detector_cfg::detection_stream detection_stream;
+
+// (magnitude, location) pair reported by the top-K peak finder
+typedef detector_cfg::peak_t peak_t;
+typedef detector_cfg::peak_stream peak_stream;
+
+// CFAR detection record; a record with last set (location -1) closes the frame
+typedef detector_cfg::cfar_detection_t cfar_detection_t;
+typedef detector_cfg::cfar_stream cfar_stream;
+
+// Top-K peak finder: number of peaks reported per frame and the minimum
+// distance in samples between two reported peaks
+#ifndef TOPK_NUM_PEAKS
+#define TOPK_NUM_PEAKS 4
+#endif
+#ifndef TOPK_MIN_SEPARATION
+#define TOPK_MIN_SEPARATION FILTER_LENGTH
+#endif
+
+// CA-CFAR: guard and training cells on each side of the cell under test, and
+// the threshold scale SCALE_NUM/SCALE_DEN applied to the mean training power
+#ifndef CFAR_GUARD
+#define CFAR_GUARD 4
+#endif
+#ifndef CFAR_TRAIN
+#define CFAR_TRAIN 16
+#endif
+#ifndef CFAR_SCALE_NUM
+#define CFAR_SCALE_NUM 8
+#endif
+#ifndef CFAR_SCALE_DEN
+#define CFAR_SCALE_DEN 1
+#endif
 
 // Define constant array
 //const fixed_point corrFilterBuff[FILTER_LENGTH][3] = { /* Initialize with appropriate values */ };
@@ -30,22 +83,60 @@ void matchFilter(complex_stream& RxSignal, real_stream& FilterOut);
 void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location);
 void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location);
 
-// For FIR IP core
-const unsigned INPUT_WIDTH = 16;
-const unsigned INPUT_FRACTIONAL_BITS = 15;
-const unsigned OUTPUT_WIDTH = 32;
-const unsigned OUTPUT_FRACTIONAL_BITS = 30;
-const unsigned COEFF_WIDTH = 16;
-const unsigned COEFF_FRACTIONAL_BITS = 15;
-const unsigned COEFF_NUM = FILTER_LENGTH;
-const unsigned COEFF_SETS = 1;
-const unsigned INPUT_LENGTH = SIGNAL_LENGTH;
-const unsigned OUTPUT_LENGTH = SIGNAL_LENGTH;
-const unsigned CHAN_NUM = 1;
-const unsigned SAMPLE_PERIOD = 4;
-const unsigned SAMPLE_FREQUENCY = 64;
-typedef ap_fixed<INPUT_WIDTH, INPUT_WIDTH - INPUT_FRACTIONAL_BITS> s_data_t;
-typedef ap_fixed<OUTPUT_WIDTH, OUTPUT_WIDTH - OUTPUT_FRACTIONAL_BITS> m_data_t;
-typedef ap_uint<8> config_t;
+// Continuous mode: FIR state persists across frames, one record per frame
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections);
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections);
+
+// Top-K mode: K peaks per frame, strongest first, at least MIN_SEP samples apart
+void pulseDetectorTopK(complex_stream& RxSignal, peak_stream& Peaks);
+
+// CFAR mode: adaptive-threshold detections alongside the global peak
+void pulseDetectorCFAR(complex_stream& RxSignal, fixed_point& peak, int& location, cfar_stream& Detections);
+
+// For FIR IP core: one coefficient set, the template in the three-real form
+// at the sample word; the IP rounds it to coeff_width
+struct fir_settings {
+    static const unsigned input_width = 16;
+    static const unsigned input_fractional_bits = 15;
+    static const unsigned output_width = 32;
+    static const unsigned output_fractional_bits = 30;
+    static const unsigned coeff_width = 16;
+    static const unsigned coeff_fractional_bits = 15;
+    static const unsigned coeff_sets = 1;
+    static const unsigned num_channels = 1;
+    static const unsigned sample_period = 4;
+    static const unsigned sample_frequency = 64;
+
+    typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+
+    static constexpr double coeff(int filter, int i) {
+        return template_taps::value(i, filter - 1);
+    }
+};
+typedef detector::fir_ip<detector_cfg, fir_settings> filter_arch;
+
+// Separate FIR IP cores for pulseDetectorSelect only, so that the other tops
+// keep the single-set cores without config channels: set 0 holds the
+// template, set 1 its conjugate as a second waveform
+struct fir_select_settings : fir_settings {
+    static const unsigned coeff_sets = 2;
+
+    typedef detector::coeff::config_taps<detector_cfg, detector::coeff::conjugate<detector::recorded_template> > conjugate_taps;
+
+    static constexpr double coeff(int filter, int i) {
+        return i < FILTER_LENGTH ? template_taps::value(i, filter - 1) : conjugate_taps::value(i - FILTER_LENGTH, filter - 1);
+    }
+};
+typedef detector::fir_ip<detector_cfg, fir_select_settings> select_arch;
+const unsigned COEFF_SETS = fir_select_settings::coeff_sets;
+typedef detector::config_t config_t;
+
+// Coefficient-set mode: one of the COEFF_SETS template sets held in the FIR
+// IP cores is selected per frame through their config channels
+void matchFilter(complex_stream& RxSignal, config_t coeff_set, real_stream& FilterOut);
+void pulseDetectorSelect(complex_stream& RxSignal, config_t coeff_set, fixed_point& peak, int& location);
+
+// Running sum of CFAR training cells (wide enough for 2*CFAR_TRAIN cells, exact)
+typedef ap_fixed<32, 10> cfar_sum_t;
 
 #endif
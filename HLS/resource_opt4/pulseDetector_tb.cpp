@@ -1,125 +1,32 @@
 #include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <cstdlib>
 
 using namespace std;
 
 int main() {
     complex_stream RxSignal;
-    // complex_stream CorrFilter;
-    complex_fixed_point corrFilterArray[FILTER_LENGTH];
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
     fixed_point peak_hw;
     int location_hw;
     fixed_point peak_ref;
     int location_ref;
     int i;
 
-    // Read RxSignal from file
-    ifstream rx_file("RxSignal_in.txt");
-    if (!rx_file.is_open()) {
-        cerr << "Error opening RxSignal_in.txt" << endl;
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
         return 1;
     }
-    string line;
-    fixed_point real_part, imag_part;
-    i = 0;
-    while (getline(rx_file, line) && i < SIGNAL_LENGTH) {
-        stringstream ss(line);
-        ss >> real_part >> imag_part;
-        RxSignal.write(complex_fixed_point(real_part, imag_part));
-        i++;
-    }
-    rx_file.close();
-
-    // Read CorrFilter from file
-    ifstream corr_file("CorrFilter_in.txt");
-    if (!corr_file.is_open()) {
-        cerr << "Error opening CorrFilter_in.txt" << endl;
-        return 1;
-    }
-
-    i = 0;
-    while (getline(corr_file, line) && i < FILTER_LENGTH) {
-        stringstream ss(line);
-        ss >> real_part >> imag_part;
-        corrFilterArray[i] = complex_fixed_point(real_part, imag_part);
-        i++;
-    }
-    corr_file.close();
-
-    // Print corrFilterArray to three files
-    ofstream coeff1_file("coeff1.txt");
-    if (!coeff1_file.is_open()) {
-        cerr << "Error opening coeff1.txt" << endl;
-        return 1;
-    }
-
-    ofstream coeff2_file("coeff2.txt");
-    if (!coeff2_file.is_open()) {
-        cerr << "Error opening coeff2.txt" << endl;
-        return 1;
-    }
-
-    ofstream coeff3_file("coeff3.txt");
-    if (!coeff3_file.is_open()) {
-        cerr << "Error opening coeff3.txt" << endl;
-        return 1;
-    }
-
-    for (int k = 0; k < FILTER_LENGTH; k++) {
-        fixed_point val1 = corrFilterArray[k].real() + corrFilterArray[k].imag();
-        fixed_point val2 = corrFilterArray[k].real() - corrFilterArray[k].imag();
-        fixed_point val3 = corrFilterArray[k].imag();
-
-        coeff1_file << val1;
-        if (k < FILTER_LENGTH - 1) {
-            coeff1_file << "," << endl;
-        } else {
-            coeff1_file << endl;
-        }
-
-        coeff2_file << val2;
-        if (k < FILTER_LENGTH - 1) {
-            coeff2_file << "," << endl;
-        } else {
-            coeff2_file << endl;
-        }
-
-        coeff3_file << val3;
-        if (k < FILTER_LENGTH - 1) {
-            coeff3_file << "," << endl;
-        } else {
-            coeff3_file << endl;
-        }
-    }
-    coeff1_file.close();
-    coeff2_file.close();
-    coeff3_file.close();
-
-    // Print corrFilterArray to file
-    ofstream init_file("corrFilterArray.txt");
-    if (!init_file.is_open()) {
-        cerr << "Error opening corrFilterArray.txt" << endl;
-        return 1;
-    }
-    //init_file << "{" << endl;
-    for (int k = 0; k < FILTER_LENGTH; k++) {
-        fixed_point val1 = corrFilterArray[k].real() + corrFilterArray[k].imag();
-        fixed_point val2 = corrFilterArray[k].real() - corrFilterArray[k].imag();
-        fixed_point val3 = corrFilterArray[k].imag();
-
-        init_file << "{" << val1 << ", " << val2 << ", " << val3 << "}";
-        if (k < FILTER_LENGTH - 1) {
-            init_file << "," << endl;
-        } else {
-            init_file << endl;
-        }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        RxSignal.write(rxSignalArray[i]);
     }
-    //init_file << "}";
-    init_file.close();
-
     // Run the pulse detector
     pulseDetector(RxSignal, peak_hw, location_hw);
 
@@ -145,7 +52,119 @@ int main() {
     cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
     cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
 
-    if (location_hw + 1 == location_ref) {
+    bool passed = (location_hw + 1 == location_ref);
+
+    // Continuous mode: rotate the signal so that the pulse straddles the frame
+    // boundary and feed it as back-to-back frames. Every frame after the first
+    // sees the tail of its predecessor in the delay line, so it must report the
+    // same peak as the single-frame run.
+    const int NUM_STREAM_FRAMES = 3;
+    const int STREAM_OFFSET = location_hw - FILTER_LENGTH / 2;
+    complex_stream RxStream;
+    detection_stream Detections;
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxStream.write(rxSignalArray[(k + STREAM_OFFSET) % SIGNAL_LENGTH]);
+        }
+        pulseDetectorStream(RxStream, Detections);
+    }
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        detection_t det = Detections.read();
+        cout << "Stream Frame: " << det.frame << ", Peak: " << det.peak << ", Location: " << det.location << endl;
+        if (det.frame != f) {
+            passed = false;
+        }
+        if (f > 0 && (det.location != location_hw - STREAM_OFFSET || det.peak != peak_hw)) {
+            passed = false;
+        }
+    }
+
+    // Top-K mode: the strongest reported peak must match the single-frame
+    // argmax, and the list must be sorted and respect the minimum separation
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(rxSignalArray[k]);
+    }
+    peak_stream Peaks;
+    pulseDetectorTopK(RxSignal, Peaks);
+
+    peak_t topk[TOPK_NUM_PEAKS];
+    for (int k = 0; k < TOPK_NUM_PEAKS; k++) {
+        topk[k] = Peaks.read();
+        cout << "Top-K Peak " << k << ": " << topk[k].peak << ", Location: " << topk[k].location << endl;
+    }
+    if (topk[0].location != location_hw || topk[0].peak != peak_hw) {
+        passed = false;
+    }
+    for (int k = 1; k < TOPK_NUM_PEAKS; k++) {
+        if (topk[k].peak > topk[k - 1].peak) {
+            passed = false;
+        }
+        for (int j = 0; j < k; j++) {
+            if (topk[k].location >= 0 && abs(topk[k].location - topk[j].location) < TOPK_MIN_SEPARATION) {
+                passed = false;
+            }
+        }
+    }
+
+    // One isolated peak with a decaying skirt never rises again after the
+    // peak, so it fills one slot and leaves the others empty
+    const int SKIRT_K = 4;
+    const int SKIRT_MIN_SEP = 4;
+    real_stream Skirt;
+    peak_stream SkirtPeaks;
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        Skirt.write(n < 10 ? fixed_point(0) : fixed_point(0.5 / (n - 9)));
+    }
+    detector::peakFinderTopK<detector_cfg, SKIRT_K, SKIRT_MIN_SEP>(Skirt, SkirtPeaks);
+    for (int k = 0; k < SKIRT_K; k++) {
+        peak_t p = SkirtPeaks.read();
+        cout << "Skirt Peak " << k << ": " << p.peak << ", Location: " << p.location << endl;
+        if (k == 0 ? (p.location != 10 || p.peak != fixed_point(0.5)) : p.location != -1) {
+            passed = false;
+        }
+    }
+
+    // CFAR mode: the global peak is unchanged and the pulse is among the
+    // adaptive-threshold detections
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        RxSignal.write(rxSignalArray[k]);
+    }
+    cfar_stream CfarDetections;
+    fixed_point peak_cfar;
+    int location_cfar;
+    pulseDetectorCFAR(RxSignal, peak_cfar, location_cfar, CfarDetections);
+
+    bool pulse_detected = false;
+    int num_cfar = 0;
+    for (cfar_detection_t det = CfarDetections.read(); !det.last; det = CfarDetections.read()) {
+        cout << "CFAR Detection: " << det.peak << ", Location: " << det.location << endl;
+        if (det.location == location_hw) {
+            pulse_detected = true;
+        }
+        num_cfar++;
+    }
+    cout << "CFAR Detections: " << num_cfar << endl;
+    if (!pulse_detected || location_cfar != location_hw || peak_cfar != peak_hw) {
+        passed = false;
+    }
+
+    // Coefficient-set mode: switch to the second set for one frame and back
+    fixed_point peak_select[3];
+    int location_select[3];
+    for (int f = 0; f < 3; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxSignal.write(rxSignalArray[k]);
+        }
+        pulseDetectorSelect(RxSignal, f == 1 ? 1 : 0, peak_select[f], location_select[f]);
+        cout << "Coefficient Set: " << (f == 1 ? 1 : 0) << ", Peak: " << peak_select[f] << ", Location: " << location_select[f] << endl;
+    }
+    if (location_select[0] != location_hw || location_select[1] == location_hw || location_select[2] != location_hw) {
+        passed = false;
+    }
+
+    if (passed) {
         cout << "Test passed!" << endl;
         return 0;
     } else {
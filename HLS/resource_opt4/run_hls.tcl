@@ -21,18 +21,22 @@ puts "PROJ=${PROJ}"
 
 #edit the below line to match project
 set basename "pulseDetector"
+# top function: ${basename} (single frame), ${basename}Stream (continuous mode)
+# ${basename}TopK (top-K peaks), ${basename}CFAR (CA-CFAR detections)
+# or ${basename}Select (per-frame coefficient set)
+set TOP ${basename}
 
 open_project -reset proj_${basename}
-set_top ${basename}
+set_top ${TOP}
 
 #add_files ${basename}.cpp -cflags "${INCL}"
-add_files ${basename}.cpp
+# the tap tables are constexpr code (pulseDetectorTaps.hpp)
+add_files ${basename}.cpp -cflags "-std=c++14"
 
 
 #add_files -tb ${basename}_tb.cpp  -cflags "${INCL_TB}"
-add_files -tb ${basename}_tb.cpp
+add_files -tb ${basename}_tb.cpp -cflags "-std=c++14"
 add_files -tb RxSignal_in.txt
-add_files -tb CorrFilter_in.txt
 add_files -tb peak_out.txt
 add_files -tb location_out.txt
 
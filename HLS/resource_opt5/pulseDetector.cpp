@@ -0,0 +1,205 @@
+#include "pulseDetector.hpp"
+#include <cmath>
+#include <complex>
+
+static_assert((FFT_LENGTH & (FFT_LENGTH - 1)) == 0, "FFT_LENGTH must be a power of two");
+static_assert(OLS_STEP >= FILTER_LENGTH - 1, "FFT_LENGTH must be at least 2*(FILTER_LENGTH-1)");
+
+// Three-real-filter coefficients for the time-domain engine
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = template_rom::value;
+
+// W^m = exp(-j*2*pi*m/FFT_LENGTH) for m = 0 .. FFT_LENGTH/2-1
+const fixed_point (&fftTwiddle)[FFT_LENGTH / 2][2] = detector::coeff::complex_rom<fixed_point, twiddle_table>::value;
+
+// FFT of the zero-padded filter taps in bit-reversed order, which is the
+// order the forward transform produces its output in
+const spectrum_t (&corrFilterSpectrum)[FFT_LENGTH][2] = detector::coeff::complex_rom<spectrum_t, spectrum_table>::value;
+
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+    detector::matchFilter<detector_cfg, filter_arch>(RxSignal, corrFilterBuff, FilterOut);
+}
+
+// (a + jb) * (c + jd) with three real multipliers, the same decomposition the
+// time-domain filter uses: k1 = c(a+b), k2 = a(d-c), k3 = b(c+d). COEF_T is
+// fixed_point for the twiddles and spectrum_t for the template spectrum.
+template<typename COEF_T>
+static complex_fft_t complexMult(complex_fft_t x, COEF_T c, COEF_T d) {
+#pragma HLS INLINE
+    fft_data_t k1 = c * (x.real() + x.imag());
+    fft_data_t k2 = x.real() * (d - c);
+    fft_data_t k3 = x.imag() * (c + d);
+    return complex_fft_t(k1 - k3, k1 + k2);
+}
+
+// Cut the input into FFT_LENGTH blocks that overlap by FILTER_LENGTH-1
+// samples. The first block is preceded by zeros, like the cleared delay
+// line of the time-domain filter, and the last one is zero-padded.
+static void olsSegment(complex_stream& RxSignal, fft_stream& out) {
+    complex_fft_t overlap[FILTER_LENGTH - 1];
+    for (int i = 0; i < FILTER_LENGTH - 1; i++) {
+        overlap[i] = 0;
+    }
+
+    int sample = 0;
+    for (int b = 0; b < OLS_BLOCKS; b++) {
+        for (int i = 0; i < FFT_LENGTH; i++) {
+#pragma HLS PIPELINE II=1
+            complex_fft_t x(0, 0);
+            if (i < FILTER_LENGTH - 1) {
+                x = overlap[i];
+            } else if (sample < SIGNAL_LENGTH) {
+                complex_fixed_point rx_sample = RxSignal.read();
+                x = complex_fft_t(rx_sample.real(), rx_sample.imag());
+                sample++;
+            }
+
+            // The tail of this block is the head of the next one
+            if (i >= OLS_STEP) {
+                overlap[i - OLS_STEP] = x;
+            }
+            out.write(x);
+        }
+    }
+}
+
+// Radix-2 single-path delay feedback stage with butterfly span D. One sample
+// is accepted and produced per clock; the stage delays the stream by D
+// samples and is flushed with zeros after the last block.
+//  - forward: decimation in frequency, twiddle after the butterfly
+//  - inverse: decimation in time, conjugate twiddle before the butterfly and
+//    a 1/2 scaling per stage so that the log2(FFT_LENGTH) stages divide by N
+template<int D, bool INVERSE>
+void fftStage(fft_stream& in, fft_stream& out) {
+    const int TOTAL = OLS_BLOCKS * FFT_LENGTH;
+
+    complex_fft_t delay[D];
+    for (int k = 0; k < D; k++) {
+        delay[k] = 0;
+    }
+
+    for (int t = 0; t < TOTAL + D; t++) {
+#pragma HLS PIPELINE II=1
+        complex_fft_t x(0, 0);
+        if (t < TOTAL) {
+            x = in.read();
+        }
+
+        int c = t % (2 * D);
+        int ptr = t % D;
+        int m = ptr * (FFT_LENGTH / (2 * D)); // twiddle exponent of the second-half butterfly
+        complex_fft_t a = delay[ptr];
+        complex_fft_t y;
+
+        if (c < D) {
+            // First half of a group: park the input, emit the differences of
+            // the previous group
+            y = a;
+            delay[ptr] = x;
+        } else if (!INVERSE) {
+            complex_fft_t diff(a.real() - x.real(), a.imag() - x.imag());
+            y = complex_fft_t(a.real() + x.real(), a.imag() + x.imag());
+            delay[ptr] = complexMult<fixed_point>(diff, fftTwiddle[m][0], fftTwiddle[m][1]);
+        } else {
+            complex_fft_t xw = complexMult<fixed_point>(x, fftTwiddle[m][0], -fftTwiddle[m][1]);
+            fft_data_t sum_real = a.real() + xw.real();
+            fft_data_t sum_imag = a.imag() + xw.imag();
+            fft_data_t diff_real = a.real() - xw.real();
+            fft_data_t diff_imag = a.imag() - xw.imag();
+            y = complex_fft_t(sum_real >> 1, sum_imag >> 1);
+            delay[ptr] = complex_fft_t(diff_real >> 1, diff_imag >> 1);
+        }
+
+        if (t >= D) {
+            out.write(y);
+        }
+    }
+}
+
+// Forward stages with span FFT_LENGTH/2 down to 1: natural in, bit-reversed out
+template<int D>
+void fftForward(fft_stream& in, fft_stream& out) {
+#pragma HLS INLINE
+    fft_stream stage_out;
+    fftStage<D, false>(in, stage_out);
+    fftForward<D / 2>(stage_out, out);
+}
+
+template<>
+void fftForward<1>(fft_stream& in, fft_stream& out) {
+#pragma HLS INLINE
+    fftStage<1, false>(in, out);
+}
+
+// Inverse stages with span 1 up to FFT_LENGTH/2: bit-reversed in, natural out
+template<int D>
+void fftInverse(fft_stream& in, fft_stream& out) {
+#pragma HLS INLINE
+    fft_stream stage_out;
+    fftStage<D, true>(in, stage_out);
+    fftInverse<D * 2>(stage_out, out);
+}
+
+template<>
+void fftInverse<FFT_LENGTH / 2>(fft_stream& in, fft_stream& out) {
+#pragma HLS INLINE
+    fftStage<FFT_LENGTH / 2, true>(in, out);
+}
+
+// Multiply by the template spectrum; both are in bit-reversed order
+static void spectrumMult(fft_stream& in, fft_stream& out) {
+    for (int b = 0; b < OLS_BLOCKS; b++) {
+        for (int i = 0; i < FFT_LENGTH; i++) {
+#pragma HLS PIPELINE II=1
+            complex_fft_t x = in.read();
+            out.write(complexMult<spectrum_t>(x, corrFilterSpectrum[i][0], corrFilterSpectrum[i][1]));
+        }
+    }
+}
+
+// Drop the FILTER_LENGTH-1 circularly wrapped samples at the head of each
+// block and the zero-padded tail of the last one
+static void olsDiscard(fft_stream& in, real_stream& FilterOut) {
+    int sample = 0;
+    for (int b = 0; b < OLS_BLOCKS; b++) {
+        for (int i = 0; i < FFT_LENGTH; i++) {
+#pragma HLS PIPELINE II=1
+            complex_fft_t y = in.read();
+            if (i >= FILTER_LENGTH - 1 && sample < SIGNAL_LENGTH) {
+                complex_fixed_point convSum(y.real(), y.imag());
+                fixed_point sum_mag_squared = convSum.real() * convSum.real() + convSum.imag() * convSum.imag();
+                DETECTOR_PROBE_VALUE(sum_mag_squared, fixed_point, double(convSum.real() * convSum.real() + convSum.imag() * convSum.imag()));
+                FilterOut.write(sum_mag_squared); // Magnitude squared
+                sample++;
+            }
+        }
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+void matchFilterFFT(complex_stream& RxSignal, real_stream& FilterOut) {
+#pragma HLS DATAFLOW
+    fft_stream segment_out, fft_out, mult_out, ifft_out;
+
+    olsSegment(RxSignal, segment_out);
+    fftForward<FFT_LENGTH / 2>(segment_out, fft_out);
+    spectrumMult(fft_out, mult_out);
+    fftInverse<1>(mult_out, ifft_out);
+    olsDiscard(ifft_out, FilterOut);
+}
+
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
+    detector::peakFinder<detector_cfg>(FilterOut, peak, location);
+}
+
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+#if MATCH_FILTER_FFT
+    matchFilterFFT(RxSignal, FilterOut);
+#else
+    matchFilter(RxSignal, FilterOut);
+#endif
+    peakFinder(FilterOut, peak, location);
+}
@@ -0,0 +1,95 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorCore.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Template: 0 the recorded pulse, 1 a FILTER_LENGTH-tap linear FM chirp
+// (lfm_chirp), the long template the FFT engine is meant for
+#ifndef LONG_TEMPLATE
+#define LONG_TEMPLATE 0
+#endif
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps.
+#ifndef FILTER_LENGTH
+#if LONG_TEMPLATE
+#define FILTER_LENGTH 1024
+#else
+#define FILTER_LENGTH 64
+#endif
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits throughout; the
+// direct-form engine uses three real filters
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<18, 2> > detector_cfg;
+typedef detector::three_real_mult<detector_cfg> filter_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Compiled-in template in the three-real form, built at compile time
+#if LONG_TEMPLATE
+typedef detector::coeff::lfm_chirp<FILTER_LENGTH> pulse_template;
+#else
+typedef detector::recorded_template pulse_template;
+#endif
+typedef detector::coeff::config_taps<detector_cfg, pulse_template> template_taps;
+typedef detector::coeff::tap_rom<fixed_point, template_taps> template_rom;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+typedef hls::stream<int> int_stream;
+
+// Matched filter engine: 1 = FFT overlap-save, 0 = direct-form three real filters
+#ifndef MATCH_FILTER_FFT
+#define MATCH_FILTER_FFT 1
+#endif
+
+// Overlap-save parameters: each FFT_LENGTH block yields OLS_STEP new outputs
+#ifndef FFT_LENGTH
+#if LONG_TEMPLATE
+#define FFT_LENGTH 2048
+#else
+#define FFT_LENGTH 256
+#endif
+#endif
+#define OLS_STEP (FFT_LENGTH - FILTER_LENGTH + 1)
+#define OLS_BLOCKS ((SIGNAL_LENGTH + OLS_STEP - 1) / OLS_STEP)
+
+// FFT datapath: the LSB of fixed_point, and its integer bits plus one per
+// radix-2 stage for the growth of the forward transform and one for the sum
+// a+b inside the three-multiplier complex product
+static const int FFT_INT_BITS = fixed_point::iwidth + detector::log2_ceil<FFT_LENGTH>::value + 1;
+typedef ap_fixed<FFT_INT_BITS + fixed_point::width - fixed_point::iwidth, FFT_INT_BITS> fft_data_t;
+typedef std::complex<fft_data_t> complex_fft_t;
+typedef hls::stream<complex_fft_t> fft_stream;
+
+// Template spectrum word: the LSB of fixed_point, and integer bits for the
+// largest bin, the sum of |re| + |im| over FILTER_LENGTH taps
+static const int SPECTRUM_INT_BITS = fixed_point::iwidth + 1 + detector::log2_ceil<FILTER_LENGTH>::value;
+typedef ap_fixed<SPECTRUM_INT_BITS + fixed_point::width - fixed_point::iwidth, SPECTRUM_INT_BITS> spectrum_t;
+
+// Twiddle factors in the fixed_point word and the template spectrum in
+// spectrum_t, built at compile time (pulseDetectorTaps.hpp)
+typedef detector::coeff::fft_twiddle<FFT_LENGTH, fixed_point::width, fixed_point::width - fixed_point::iwidth> twiddle_table;
+typedef detector::coeff::fft_spectrum<pulse_template, FFT_LENGTH, fixed_point::width, fixed_point::width - fixed_point::iwidth,
+                                      spectrum_t::width> spectrum_table;
+
+// Function declarations
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut);
+void matchFilterFFT(complex_stream& RxSignal, real_stream& FilterOut);
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location);
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location);
+
+#endif
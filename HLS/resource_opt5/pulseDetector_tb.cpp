@@ -0,0 +1,147 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+
+using namespace std;
+
+// Largest difference allowed between the FFT and time-domain magnitudes. The
+// direct form truncates every product to the 2^-16 LSB and the FFT every
+// stage; on the recorded capture they differ by at most 2^-12 at any
+// FFT_LENGTH
+const double FFT_TOLERANCE = 2.5e-4;
+
+// LONG_TEMPLATE: a quiet frame holding the chirp, conjugated and time
+// reversed as the matched return, ending at PULSE_END. At PULSE_GAIN the
+// correlation peak is near one, inside the sample word, while the template
+// spectrum peaks far above it. The truncation error of the direct form grows
+// with the number of taps and the peak, so the tolerance is LONG_TOLERANCE of
+// the peak.
+const int PULSE_END = 2500;
+const double PULSE_GAIN = 1.0 / 64;
+const double IDLE_NOISE = 1.0 / 1024;
+const double LONG_TOLERANCE = 1.0 / 256;
+
+static void chirpFrame(complex_fixed_point frame[SIGNAL_LENGTH]) {
+    unsigned state = 12345u;
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        double noise[2];
+        for (int c = 0; c < 2; c++) {
+            state = state * 1664525u + 1013904223u;
+            noise[c] = IDLE_NOISE * (((state >> 8) & 0xffff) / 32768.0 - 1);
+        }
+        int j = PULSE_END - k;
+        if (j >= 0 && j < pulse_template::length) {
+            noise[0] += PULSE_GAIN * pulse_template::value(j, 0);
+            noise[1] -= PULSE_GAIN * pulse_template::value(j, 1);
+        }
+        frame[k] = complex_fixed_point(noise[0], noise[1]);
+    }
+}
+
+int main() {
+    complex_stream RxSignal;
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw;
+    int location_ref;
+    int i;
+
+#if LONG_TEMPLATE
+    // The capture holds the recorded pulse, so the long template runs on a
+    // synthetic frame instead
+    chirpFrame(rxSignalArray);
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(rxSignalArray[i]);
+    }
+    pulseDetector(RxSignal, peak_hw, location_hw);
+    location_ref = PULSE_END + 1;
+
+    double spectrum_peak = 0;
+    for (i = 0; i < FFT_LENGTH; i++) {
+        spectrum_peak = fmax(spectrum_peak, fmax(fabs(spectrum_table::value(i, 0)), fabs(spectrum_table::value(i, 1))));
+    }
+    cout << "Long template: " << FILTER_LENGTH << " taps, spectrum peak " << spectrum_peak << ", spectrum word ap_fixed<"
+         << spectrum_t::width << ", " << spectrum_t::iwidth << ">" << endl;
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
+    cout << "Pulse end: " << PULSE_END << endl;
+#else
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        RxSignal.write(rxSignalArray[i]);
+    }
+    // Run the pulse detector
+    pulseDetector(RxSignal, peak_hw, location_hw);
+
+    // Read reference peak from file
+    fixed_point peak_ref;
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+#endif
+
+    bool passed = (location_hw + 1 == location_ref);
+
+    // Both engines on the same frame: the FFT output must follow the
+    // time-domain filter sample by sample
+    complex_stream RxDirect, RxFFT;
+    real_stream DirectOut, FFTOut;
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        RxDirect.write(rxSignalArray[i]);
+        RxFFT.write(rxSignalArray[i]);
+    }
+    matchFilter(RxDirect, DirectOut);
+    matchFilterFFT(RxFFT, FFTOut);
+
+    double max_diff = 0;
+    int max_diff_location = 0;
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        double diff = fabs(FFTOut.read().to_double() - DirectOut.read().to_double());
+        if (diff > max_diff) {
+            max_diff = diff;
+            max_diff_location = i;
+        }
+    }
+    cout << "Engine: " << (MATCH_FILTER_FFT ? "FFT" : "direct") << ", FFT length: " << FFT_LENGTH << endl;
+    cout << "FFT vs time domain, max difference: " << max_diff << " at " << max_diff_location << endl;
+#if LONG_TEMPLATE
+    if (max_diff > LONG_TOLERANCE * peak_hw.to_double()) {
+#else
+    if (max_diff > FFT_TOLERANCE) {
+#endif
+        passed = false;
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
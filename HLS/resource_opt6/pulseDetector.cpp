@@ -0,0 +1,80 @@
+#include "pulseDetector.hpp"
+
+#if MATCH_FILTER_FIR_IP
+
+// With num_channels > 1 the FIR IP core expects the channels interleaved on
+// its input and keeps one delay line per channel internally, sharing the
+// multipliers between them.
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+    filter_arch::matchFilter(RxSignal, FilterOut);
+}
+
+#else
+
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = template_rom::value;
+
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+    // Every delay element of the single-channel filter becomes NUM_CHANNELS
+    // deep (z^-N), so tap j of the channel currently at the input sits at
+    // dataBuff[j * NUM_CHANNELS], and one set of multipliers serves all
+    // channels. The delay line is static and never cleared, like the FIR IP
+    // core's, so a frame starts with the tail of the previous one as in
+    // matchFilterStream. With no reset, no clear and no readers between the
+    // taps, the N - 1 registers of each segment are a plain shift chain that
+    // maps to SRLs instead of (FILTER_LENGTH - 1) * N + 1 flip-flop words.
+    const int BUFF_LENGTH = (FILTER_LENGTH - 1) * NUM_CHANNELS + 1;
+
+    static complex_fixed_point dataBuff[BUFF_LENGTH];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+#pragma HLS PIPELINE II=1 rewind
+        detector::shiftIn<detector_cfg, BUFF_LENGTH>(dataBuff, RxSignal.read());
+        FilterOut.write(filter_arch::correlate<NUM_CHANNELS>(dataBuff, corrFilterBuff));
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+#endif
+
+void peakFinder(real_stream& FilterOut, channel_detection_stream& Detections) {
+    fixed_point current_peak[NUM_CHANNELS];
+    int current_location[NUM_CHANNELS];
+#pragma HLS ARRAY_PARTITION variable=current_peak complete dim=1
+#pragma HLS ARRAY_PARTITION variable=current_location complete dim=1
+
+    for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+        current_peak[ch] = 0;
+        current_location[ch] = 0;
+    }
+
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+#pragma HLS PIPELINE II=1
+            fixed_point magVal = FilterOut.read();
+
+            if (magVal > current_peak[ch]) {
+                current_peak[ch] = magVal;
+                current_location[ch] = n;
+            }
+        }
+    }
+
+    for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+#pragma HLS PIPELINE II=1
+        channel_detection_t det;
+        det.channel = ch;
+        det.peak = current_peak[ch];
+        det.location = current_location[ch];
+        Detections.write(det);
+    }
+}
+
+void pulseDetector(complex_stream& RxSignal, channel_detection_stream& Detections) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilter(RxSignal, FilterOut);
+    peakFinder(FilterOut, Detections);
+}
@@ -0,0 +1,83 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorFirIp.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions
+#define FILTER_LENGTH 64
+#define SIGNAL_LENGTH 5000
+
+// Channels interleaved sample by sample (ch0, ch1, ..., chN-1, ch0, ...) on
+// one stream; a frame holds SIGNAL_LENGTH samples of every channel
+#ifndef NUM_CHANNELS
+#define NUM_CHANNELS 8
+#endif
+#define FRAME_SAMPLES (SIGNAL_LENGTH * NUM_CHANNELS)
+
+// Detector instance: 18-bit fixed-point with 2 integer bits throughout; the
+// filter sees one interleaved frame of FRAME_SAMPLES
+typedef detector::config<FILTER_LENGTH, FRAME_SAMPLES, ap_fixed<18, 2> > detector_cfg;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Compiled-in template in the three-real form, built at compile time; the
+// hand-written filter reads it as a ROM and the FIR IP cores as coefficients
+typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+typedef detector::coeff::tap_rom<fixed_point, template_taps> template_rom;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+typedef hls::stream<int> int_stream;
+
+// Per-channel detection record, NUM_CHANNELS of them per frame
+struct channel_detection_t {
+    int channel;
+    fixed_point peak;
+    int location;
+};
+typedef hls::stream<channel_detection_t> channel_detection_stream;
+
+// Matched filter engine: 1 = FIR IP cores with num_channels, 0 = hand-written
+#ifndef MATCH_FILTER_FIR_IP
+#define MATCH_FILTER_FIR_IP 0
+#endif
+
+// Function declarations
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut);
+void peakFinder(real_stream& FilterOut, channel_detection_stream& Detections);
+void pulseDetector(complex_stream& RxSignal, channel_detection_stream& Detections);
+
+// For FIR IP core
+struct fir_settings {
+    static const unsigned input_width = 16;
+    static const unsigned input_fractional_bits = 15;
+    static const unsigned output_width = 32;
+    static const unsigned output_fractional_bits = 30;
+    static const unsigned coeff_width = 16;
+    static const unsigned coeff_fractional_bits = 15;
+    static const unsigned coeff_sets = 1;
+    static const unsigned num_channels = NUM_CHANNELS;
+    static const unsigned sample_period = 4;
+    static const unsigned sample_frequency = 64;
+
+    static constexpr double coeff(int filter, int i) {
+        return template_taps::value(i, filter - 1);
+    }
+};
+
+#if MATCH_FILTER_FIR_IP
+typedef detector::fir_ip<detector_cfg, fir_settings> filter_arch;
+#else
+typedef detector::three_real_mult<detector_cfg> filter_arch;
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// Channel c carries the test signal advanced by c * CHANNEL_OFFSET samples,
+// so its pulse is expected CHANNEL_OFFSET samples earlier than channel c-1's
+#define CHANNEL_OFFSET 200
+
+int main() {
+    complex_stream RxSignal;
+    channel_detection_stream Detections;
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_ref;
+    int location_ref;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+    }
+
+    // Interleave the channels sample by sample
+    for (int n = 0; n < SIGNAL_LENGTH; n++) {
+        for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+            RxSignal.write(rxSignalArray[(n + ch * CHANNEL_OFFSET) % SIGNAL_LENGTH]);
+        }
+    }
+
+    // Run the pulse detector
+    pulseDetector(RxSignal, Detections);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = true;
+    fixed_point peak_ch0 = 0;
+    for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+        channel_detection_t det = Detections.read();
+        cout << "Channel: " << det.channel << ", Hardware Peak: " << det.peak << ", Location: " << det.location << endl;
+        if (ch == 0) {
+            peak_ch0 = det.peak;
+        }
+        // Every channel sees the same pulse samples, so the peak is identical
+        if (det.channel != ch || det.location + 1 != location_ref - ch * CHANNEL_OFFSET || det.peak != peak_ch0) {
+            passed = false;
+        }
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,36 @@
+#include "pulseDetector.hpp"
+
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut) {
+    filter_arch::matchFilter(RxSignal, FilterOut);
+}
+
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location) {
+    detector::peakFinder<detector_cfg>(FilterOut, peak, location);
+}
+
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilter(RxSignal, FilterOut);
+    peakFinder(FilterOut, peak, location);
+}
+
+void matchFilterStream(complex_stream& RxSignal, real_stream& FilterOut) {
+    filter_arch::matchFilterStream(RxSignal, FilterOut);
+}
+
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections) {
+    detector::peakFinderStream<detector_cfg>(FilterOut, Detections);
+}
+
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections) {
+#pragma HLS INTERFACE mode=ap_ctrl_none port=return
+#pragma HLS DATAFLOW
+    real_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilterStream(RxSignal, FilterOut);
+    peakFinderStream(FilterOut, Detections);
+}
@@ -0,0 +1,65 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorCsd.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps; the
+// taps are recoded for whatever word width results.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+// Digit pairs shared per filter by the CSD shift-add trees
+#ifndef CSD_SHARED_PAIRS
+#define CSD_SHARED_PAIRS 4
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// three real filters built from CSD shift-add trees instead of multipliers
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+
+// The recorded template in the three-real form, built at compile time for the
+// CSD recoding
+typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+
+typedef detector::csd_shift_add<detector_cfg, template_taps, CSD_SHARED_PAIRS> filter_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+typedef hls::stream<int> int_stream;
+
+// Per-frame detection record emitted by the continuous (free-running) mode
+typedef detector_cfg::detection_t detection_t;
+typedef detector_cfg::detection_stream detection_stream;
+
+// Function declarations
+void matchFilter(complex_stream& RxSignal, real_stream& FilterOut);
+void peakFinder(real_stream& FilterOut, fixed_point& peak, int& location);
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location);
+
+// Continuous mode: filter state persists across frames, one record per frame
+void matchFilterStream(complex_stream& RxSignal, real_stream& FilterOut);
+void peakFinderStream(real_stream& FilterOut, detection_stream& Detections);
+void pulseDetectorStream(complex_stream& RxSignal, detection_stream& Detections);
+
+#endif
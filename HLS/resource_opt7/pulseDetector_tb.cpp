@@ -0,0 +1,116 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// resource_opt3 datapath with multipliers, the bit-exact reference
+typedef detector::three_real_mult<detector_cfg> reference_arch;
+
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = detector::coeff::tap_rom<fixed_point, template_taps>::value;
+
+int main() {
+    complex_stream RxSignal;
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw;
+    fixed_point peak_ref;
+    int location_ref;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+    }
+
+    // Every filter output word must match the three-real multiplier filter
+    complex_stream RxCsd, RxRef;
+    real_stream FilterCsd, FilterRef;
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        RxCsd.write(rxSignalArray[i]);
+        RxRef.write(rxSignalArray[i]);
+    }
+    matchFilter(RxCsd, FilterCsd);
+    detector::matchFilter<detector_cfg, reference_arch>(RxRef, corrFilterBuff, FilterRef);
+    int mismatches = 0;
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        if (FilterCsd.read() != FilterRef.read()) {
+            mismatches++;
+        }
+    }
+
+    cout << "Shift-add adders per sample: " << filter_arch::adders() << " (" << filter_arch::addersUnshared()
+         << " without shared pairs), filter output mismatches: " << mismatches << endl;
+
+    // Run the pulse detector
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(rxSignalArray[i]);
+    }
+    pulseDetector(RxSignal, peak_hw, location_hw);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = mismatches == 0 && location_hw + 1 == location_ref;
+
+    // Continuous mode: rotate the signal so that the pulse straddles the frame
+    // boundary and feed it as back-to-back frames; the partial sums carry the
+    // tail of the previous frame, so every frame after the first must report
+    // the single-frame peak
+    const int NUM_STREAM_FRAMES = 3;
+    const int STREAM_OFFSET = location_hw - FILTER_LENGTH / 2;
+    complex_stream RxStream;
+    detection_stream Detections;
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        for (int k = 0; k < SIGNAL_LENGTH; k++) {
+            RxStream.write(rxSignalArray[(k + STREAM_OFFSET) % SIGNAL_LENGTH]);
+        }
+        pulseDetectorStream(RxStream, Detections);
+    }
+
+    for (int f = 0; f < NUM_STREAM_FRAMES; f++) {
+        detection_t det = Detections.read();
+        cout << "Stream Frame: " << det.frame << ", Peak: " << det.peak << ", Location: " << det.location << endl;
+        if (det.frame != f) {
+            passed = false;
+        }
+        if (f > 0 && (det.location != location_hw - STREAM_OFFSET || det.peak != peak_hw)) {
+            passed = false;
+        }
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
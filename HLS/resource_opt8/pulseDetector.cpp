@@ -0,0 +1,24 @@
+#include "pulseDetector.hpp"
+
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = template_rom::value;
+
+void coarseDetector(complex_stream& RxSignal, int threshold, complex_fixed_point frameBuf[SIGNAL_LENGTH], window_stream& Windows) {
+    coarse_arch::coarseStage(RxSignal, threshold, corrFilterBuff, frameBuf, Windows);
+}
+
+void fineDetector(const complex_fixed_point frameBuf[SIGNAL_LENGTH], window_stream& Windows, fixed_point& peak, int& location,
+                  int& fine_samples, int& fine_cycles) {
+    detector::fineStage<detector_cfg, FINE_FOLD>(frameBuf, Windows, corrFilterBuff, peak, location, fine_samples, fine_cycles);
+}
+
+void pulseDetector(complex_stream& RxSignal, int threshold, fixed_point& peak, int& location, int& fine_samples, int& fine_cycles) {
+#pragma HLS DATAFLOW
+    // Ping-pong frame buffer: the coarse stage fills one frame while the fine
+    // stage searches the windows of the previous one
+    complex_fixed_point frameBuf[SIGNAL_LENGTH];
+    window_stream Windows;
+#pragma HLS STREAM variable=Windows depth=COARSE_MAX_WINDOWS+1 dim=1
+
+    coarseDetector(RxSignal, threshold, frameBuf, Windows);
+    fineDetector(frameBuf, Windows, peak, location, fine_samples, fine_cycles);
+}
@@ -0,0 +1,73 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorCoarse.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+// Fine correlator time-sharing: FINE_FOLD cycles per output, 3 * FILTER_LENGTH /
+// FINE_FOLD multipliers
+#ifndef FINE_FOLD
+#define FINE_FOLD 8
+#endif
+// Samples forwarded either side of a coarse hit, and windows per frame
+#ifndef COARSE_HALF_WIDTH
+#define COARSE_HALF_WIDTH 8
+#endif
+#ifndef COARSE_MAX_WINDOWS
+#define COARSE_MAX_WINDOWS 16
+#endif
+// Default coarse threshold, 0 .. 4 * FILTER_LENGTH; the top takes it at run time
+#ifndef COARSE_THRESHOLD
+#define COARSE_THRESHOLD 56
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// the compiled-in template (pulseDetectorTemplate.hpp) in both stages
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+typedef detector::coarse_sign<detector_cfg, COARSE_HALF_WIDTH, COARSE_MAX_WINDOWS> coarse_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Compiled-in template in the three-real form, built at compile time
+typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+typedef detector::coeff::tap_rom<fixed_point, template_taps> template_rom;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+typedef detector::window_stream window_stream;
+typedef hls::stream<int> int_stream;
+
+// Function declarations
+void coarseDetector(complex_stream& RxSignal, int threshold, complex_fixed_point frameBuf[SIGNAL_LENGTH], window_stream& Windows);
+void fineDetector(const complex_fixed_point frameBuf[SIGNAL_LENGTH], window_stream& Windows, fixed_point& peak, int& location,
+                  int& fine_samples, int& fine_cycles);
+
+// Two-stage detector: the peak and location of the full correlator whenever
+// the coarse stage forwards the window holding it. fine_samples is the number
+// of correlator outputs computed, fine_cycles the fine stage's cycle count.
+void pulseDetector(complex_stream& RxSignal, int threshold, fixed_point& peak, int& location, int& fine_samples, int& fine_cycles);
+
+#endif
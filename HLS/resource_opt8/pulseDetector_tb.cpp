@@ -0,0 +1,191 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+
+using namespace std;
+
+// resource_opt3 datapath over every sample, the reference
+typedef detector::three_real_mult<detector_cfg> reference_arch;
+
+const fixed_point (&corrFilterRef)[FILTER_LENGTH][3] = template_rom::value;
+
+// Miss rate sweep: the capture rotated and with added uniform noise of
+// +/-NOISE_LEVELS[l], FRAMES_PER_LEVEL frames each
+const int NUM_LEVELS = 4;
+const double NOISE_LEVELS[NUM_LEVELS] = {0, 0.0625, 0.125, 0.25};
+const int FRAMES_PER_LEVEL = 8;
+const int NUM_THRESHOLDS = 5;
+const int THRESHOLDS[NUM_THRESHOLDS] = {48, 52, 56, 60, 64};
+
+static unsigned lcgNext(unsigned& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void runFull(const complex_fixed_point frame[SIGNAL_LENGTH], fixed_point& peak, int& location) {
+    complex_stream RxSignal;
+    real_stream FilterOut;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    detector::matchFilter<detector_cfg, reference_arch>(RxSignal, corrFilterRef, FilterOut);
+    detector::peakFinder<detector_cfg>(FilterOut, peak, location);
+}
+
+static void runTwoStage(const complex_fixed_point frame[SIGNAL_LENGTH], int threshold, fixed_point& peak, int& location,
+                        int& fine_samples, int& fine_cycles) {
+    complex_stream RxSignal;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    pulseDetector(RxSignal, threshold, peak, location, fine_samples, fine_cycles);
+}
+
+int main() {
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    static double rx_re[SIGNAL_LENGTH], rx_im[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw;
+    fixed_point peak_ref;
+    int location_ref;
+    int fine_samples, fine_cycles;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        rx_re[i] = rxSignalArray[i].real().to_double();
+        rx_im[i] = rxSignalArray[i].imag().to_double();
+    }
+
+    // Run the pulse detector at the default threshold
+    runTwoStage(rxSignalArray, COARSE_THRESHOLD, peak_hw, location_hw, fine_samples, fine_cycles);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << ", fine samples: " << fine_samples
+         << ", fine cycles: " << fine_cycles << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = location_hw + 1 == location_ref;
+
+    // Miss rate against the full correlator. Where the locations agree the
+    // peak must be bit-exact, and the two-stage peak can never exceed the
+    // full one, since it searches a subset of the same outputs.
+    int misses[NUM_THRESHOLDS][NUM_LEVELS] = {{0}};
+    long total_samples[NUM_THRESHOLDS] = {0};
+    int max_cycles[NUM_THRESHOLDS] = {0};
+    int max_fold[NUM_THRESHOLDS];
+    for (int t = 0; t < NUM_THRESHOLDS; t++) {
+        max_fold[t] = FILTER_LENGTH;
+    }
+
+    unsigned state = 12345u;
+    complex_fixed_point frame[SIGNAL_LENGTH];
+    for (int l = 0; l < NUM_LEVELS; l++) {
+        for (int f = 0; f < FRAMES_PER_LEVEL; f++) {
+            // Rotations that keep the recorded pulse whole
+            int offset = (613 * (l * FRAMES_PER_LEVEL + f)) % (location_hw - FILTER_LENGTH);
+            for (i = 0; i < SIGNAL_LENGTH; i++) {
+                int src = (i + offset) % SIGNAL_LENGTH;
+                double noise_re = NOISE_LEVELS[l] * ((lcgNext(state) & 0xffff) / 32768.0 - 1);
+                double noise_im = NOISE_LEVELS[l] * ((lcgNext(state) & 0xffff) / 32768.0 - 1);
+                frame[i] = complex_fixed_point(rx_re[src] + noise_re, rx_im[src] + noise_im);
+            }
+
+            fixed_point peak_full, peak_two;
+            int location_full, location_two;
+            runFull(frame, peak_full, location_full);
+
+            for (int t = 0; t < NUM_THRESHOLDS; t++) {
+                runTwoStage(frame, THRESHOLDS[t], peak_two, location_two, fine_samples, fine_cycles);
+                if (location_two != location_full) {
+                    misses[t][l]++;
+                } else if (peak_two != peak_full) {
+                    passed = false;
+                }
+                if (peak_two > peak_full) {
+                    passed = false;
+                }
+
+                // Largest fold for which the fine stage keeps up with the
+                // samples: the window pre-roll takes one cycle per sample,
+                // every output FINE_FOLD cycles. 0 if even an unfolded fine
+                // stage falls behind.
+                total_samples[t] += fine_samples;
+                if (fine_cycles > max_cycles[t]) {
+                    max_cycles[t] = fine_cycles;
+                }
+                int preroll = fine_cycles - FINE_FOLD * fine_samples;
+                while (max_fold[t] > 0 && fine_samples > 0 && preroll + max_fold[t] * fine_samples > SIGNAL_LENGTH) {
+                    max_fold[t] /= 2;
+                }
+            }
+        }
+    }
+
+    cout << "Miss rate against the full correlator, " << FRAMES_PER_LEVEL << " frames per noise level" << endl;
+    cout << "threshold";
+    for (int l = 0; l < NUM_LEVELS; l++) {
+        cout << "  noise " << NOISE_LEVELS[l];
+    }
+    cout << "  fine samples/frame  max fine cycles  max fold  multipliers" << endl;
+    for (int t = 0; t < NUM_THRESHOLDS; t++) {
+        char line[64];
+        snprintf(line, sizeof(line), "%9d", THRESHOLDS[t]);
+        cout << line;
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            snprintf(line, sizeof(line), "  %*.0f%%", l == 0 ? 6 : 11, 100.0 * misses[t][l] / FRAMES_PER_LEVEL);
+            cout << line;
+        }
+        snprintf(line, sizeof(line), "  %18.1f  %15d", (double)total_samples[t] / (NUM_LEVELS * FRAMES_PER_LEVEL), max_cycles[t]);
+        cout << line;
+        if (max_fold[t] > 0) {
+            snprintf(line, sizeof(line), "  %8d  %11d", max_fold[t], 3 * FILTER_LENGTH / max_fold[t]);
+        } else {
+            snprintf(line, sizeof(line), "  %8s  %11s", "-", "-");
+        }
+        cout << line << endl;
+    }
+    cout << "Full correlator: " << 3 * FILTER_LENGTH << " multipliers" << endl;
+
+    // The clean capture must be found at every threshold up to the default
+    for (int t = 0; t < NUM_THRESHOLDS; t++) {
+        if (THRESHOLDS[t] <= COARSE_THRESHOLD && misses[t][0] != 0) {
+            passed = false;
+        }
+    }
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
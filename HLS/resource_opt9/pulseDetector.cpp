@@ -0,0 +1,21 @@
+#include "pulseDetector.hpp"
+
+// Three-real taps of every bin, bin 0 at the most negative offset
+const fixed_point (&dopplerFilterBuff)[DOPPLER_BINS][FILTER_LENGTH][3] = doppler_rom::value;
+
+void matchFilterBank(complex_stream& RxSignal, doppler_stream& BankOut) {
+    bank_arch::matchFilter(RxSignal, dopplerFilterBuff, BankOut);
+}
+
+void peakFinderBank(doppler_stream& BankOut, fixed_point& peak, int& location, int& doppler) {
+    bank_arch::peakFinder(BankOut, peak, location, doppler);
+}
+
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location, int& doppler) {
+#pragma HLS DATAFLOW
+    doppler_stream BankOut;
+#pragma HLS STREAM variable=BankOut depth=4 dim=1
+
+    matchFilterBank(RxSignal, BankOut);
+    peakFinderBank(BankOut, peak, location, doppler);
+}
@@ -0,0 +1,71 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorDoppler.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions. They can be
+// overridden from the command line for the benchmark and DSE sweeps.
+#ifndef FILTER_LENGTH
+#define FILTER_LENGTH 64
+#endif
+#ifndef SIGNAL_LENGTH
+#define SIGNAL_LENGTH 5000
+#endif
+// Sample word: ap_fixed<DATA_WIDTH, DATA_INT_BITS>
+#ifndef DATA_WIDTH
+#define DATA_WIDTH 18
+#endif
+#ifndef DATA_INT_BITS
+#define DATA_INT_BITS 2
+#endif
+// Doppler bins, centred on zero offset, and their spacing in cycles of phase
+// rotation over the filter length
+#ifndef DOPPLER_BINS
+#define DOPPLER_BINS 5
+#endif
+#ifndef DOPPLER_BIN_SPACING
+#define DOPPLER_BIN_SPACING 0.5
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits (default) throughout,
+// DOPPLER_BINS three-real correlators sharing one delay line
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<DATA_WIDTH, DATA_INT_BITS> > detector_cfg;
+typedef detector::doppler_bank<detector_cfg, DOPPLER_BINS> bank_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Three-real taps of every bin, bin 0 at the most negative offset, built at
+// compile time from the template (pulseDetectorTaps.hpp)
+struct doppler_grid {
+    static const int bins = DOPPLER_BINS;
+    static constexpr double spacing = DOPPLER_BIN_SPACING;
+};
+typedef detector::coeff::doppler_taps<detector::recorded_template, doppler_grid, FILTER_LENGTH, fixed_point::width,
+                                      fixed_point::width - fixed_point::iwidth> doppler_taps;
+typedef detector::coeff::bank_rom<fixed_point, doppler_taps> doppler_rom;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Define stream types
+typedef detector_cfg::complex_stream complex_stream;
+typedef detector_cfg::real_stream real_stream;
+typedef bank_arch::record_stream doppler_stream;
+
+// Best (peak, location, bin) of one sample or frame
+typedef bank_arch::record_t doppler_detection_t;
+
+// Function declarations
+void matchFilterBank(complex_stream& RxSignal, doppler_stream& BankOut);
+void peakFinderBank(doppler_stream& BankOut, fixed_point& peak, int& location, int& doppler);
+
+// Best peak over all bins and samples of the frame; doppler is the bin index,
+// DOPPLER_BINS / 2 for zero offset
+void pulseDetector(complex_stream& RxSignal, fixed_point& peak, int& location, int& doppler);
+
+#endif
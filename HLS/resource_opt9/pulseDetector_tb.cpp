@@ -0,0 +1,223 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+
+// One branch on its own, the resource_opt3 datapath, is the reference
+typedef detector::three_real_mult<detector_cfg> reference_arch;
+
+// Doppler sweep on a quiet frame holding one matched pulse ending at
+// PULSE_END, x[n0 - j] = A conj(t[j]) exp(2 pi i f n / FILTER_LENGTH), for
+// offsets f from one bin beyond the bank on either side in quarter bins
+const int PULSE_END = 2500;
+const double PULSE_GAIN = 8;
+const double IDLE_NOISE = 1.0 / 64;
+const int SWEEP_STEPS = 4 * (DOPPLER_BINS + 1);
+
+static complex_fixed_point corrFilterArray[FILTER_LENGTH];
+
+static void pulseFrame(double offset, complex_fixed_point frame[SIGNAL_LENGTH]) {
+    unsigned state = 12345u;
+    for (int k = 0; k < SIGNAL_LENGTH; k++) {
+        double noise[2];
+        for (int c = 0; c < 2; c++) {
+            state = state * 1664525u + 1013904223u;
+            noise[c] = IDLE_NOISE * (((state >> 8) & 0xffff) / 32768.0 - 1);
+        }
+        int j = PULSE_END - k;
+        if (j >= 0 && j < FILTER_LENGTH) {
+            double angle = 2.0 * M_PI * offset * k / FILTER_LENGTH;
+            double pulse_real = PULSE_GAIN * corrFilterArray[j].real().to_double();
+            double pulse_imag = -PULSE_GAIN * corrFilterArray[j].imag().to_double();
+            noise[0] += pulse_real * cos(angle) - pulse_imag * sin(angle);
+            noise[1] += pulse_real * sin(angle) + pulse_imag * cos(angle);
+        }
+        frame[k] = complex_fixed_point(noise[0], noise[1]);
+    }
+}
+
+static void runBank(const complex_fixed_point frame[SIGNAL_LENGTH], fixed_point& peak, int& location, int& doppler) {
+    complex_stream RxSignal;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    pulseDetector(RxSignal, peak, location, doppler);
+}
+
+// Filter output of bin d alone
+static void runBin(const complex_fixed_point frame[SIGNAL_LENGTH], int d, fixed_point mag[SIGNAL_LENGTH]) {
+    complex_stream RxSignal;
+    real_stream FilterOut;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    detector::matchFilter<detector_cfg, reference_arch>(RxSignal, doppler_rom::value[d], FilterOut);
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        mag[i] = FilterOut.read();
+    }
+}
+
+// Samples where the bank output is not the best single-bin output
+static int bankMismatches(const complex_fixed_point frame[SIGNAL_LENGTH]) {
+    static fixed_point bin_mag[DOPPLER_BINS][SIGNAL_LENGTH];
+    for (int d = 0; d < DOPPLER_BINS; d++) {
+        runBin(frame, d, bin_mag[d]);
+    }
+    complex_stream RxSignal;
+    doppler_stream BankOut;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        RxSignal.write(frame[i]);
+    }
+    matchFilterBank(RxSignal, BankOut);
+    int mismatches = 0;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        doppler_detection_t r = BankOut.read();
+        int best = 0;
+        for (int d = 1; d < DOPPLER_BINS; d++) {
+            if (bin_mag[d][i] > bin_mag[best][i]) {
+                best = d;
+            }
+        }
+        if (r.peak != bin_mag[best][i] || r.doppler != best || r.location != i) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void argmax(const fixed_point mag[SIGNAL_LENGTH], fixed_point& peak, int& location) {
+    peak = 0;
+    location = 0;
+    for (int i = 0; i < SIGNAL_LENGTH; i++) {
+        if (mag[i] > peak) {
+            peak = mag[i];
+            location = i;
+        }
+    }
+}
+
+int main() {
+    static complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw, doppler_hw;
+    fixed_point peak_ref;
+    int location_ref;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the first run
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+    }
+    // The compiled-in template, quantised to the tap word as the constexpr
+    // bank taps are
+    for (int k = 0; k < FILTER_LENGTH; k++) {
+        if (k < detector::recorded_template::length) {
+            corrFilterArray[k] = complex_fixed_point(detector::recorded_template::value(k, 0), detector::recorded_template::value(k, 1));
+        } else {
+            corrFilterArray[k] = 0;
+        }
+    }
+
+    // Run the pulse detector
+    runBank(rxSignalArray, peak_hw, location_hw, doppler_hw);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << ", Doppler bin: " << doppler_hw << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = location_hw + 1 == location_ref;
+
+    // Every bank output is the largest of the branch outputs, each bit-exact
+    // with the single-template datapath, on the capture and on a full-scale
+    // frame whose re + im overflows the sample word
+    static complex_fixed_point fullScale[SIGNAL_LENGTH];
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        fullScale[i] = i % 2 == 0 ? complex_fixed_point(1.5, 1.75) : complex_fixed_point(-1.75, -2);
+    }
+    int mismatches = bankMismatches(rxSignalArray);
+    cout << "Bank mismatches against the single-bin filters: " << mismatches << endl;
+    int full_scale_mismatches = bankMismatches(fullScale);
+    cout << "Full-scale bank mismatches against the single-bin filters: " << full_scale_mismatches << endl;
+    if (mismatches != 0 || full_scale_mismatches != 0) {
+        passed = false;
+    }
+
+    // Doppler sweep. The single template is the centre bin; losses are
+    // against the bank peak at zero offset.
+    complex_fixed_point frame[SIGNAL_LENGTH];
+    static fixed_point single_mag[SIGNAL_LENGTH];
+    fixed_point peak_zero;
+    int location_zero, doppler_zero;
+    pulseFrame(0, frame);
+    runBank(frame, peak_zero, location_zero, doppler_zero);
+    double worst_bank_loss = 0;
+    double bank_edge = DOPPLER_BINS / 2 * DOPPLER_BIN_SPACING;
+    cout << "offset (cycles)  bin  location  bank loss (dB)  single loss (dB)" << endl;
+    for (int s = -SWEEP_STEPS / 2; s <= SWEEP_STEPS / 2; s++) {
+        double offset = s * DOPPLER_BIN_SPACING / 4;
+        pulseFrame(offset, frame);
+
+        fixed_point peak_bank, peak_single;
+        int location_bank, doppler_bank, location_single;
+        runBank(frame, peak_bank, location_bank, doppler_bank);
+        runBin(frame, DOPPLER_BINS / 2, single_mag);
+        argmax(single_mag, peak_single, location_single);
+        double bank_loss = 10 * log10(peak_zero.to_double() / peak_bank.to_double());
+        double single_loss = 10 * log10(peak_zero.to_double() / peak_single.to_double());
+
+        char row[96];
+        snprintf(row, sizeof(row), "%15.3f  %3d  %8d  %14.2f  %16.2f", offset, doppler_bank, location_bank, bank_loss, single_loss);
+        cout << row << endl;
+
+        // Inside the bank the nearest bin must win, off by one only half way
+        // between two bins, and the pulse is found where it ends
+        if (fabs(offset) <= bank_edge) {
+            double nearest = offset / DOPPLER_BIN_SPACING + DOPPLER_BINS / 2;
+            if (fabs(doppler_bank - nearest) > 0.5 || location_bank != PULSE_END) {
+                passed = false;
+            }
+            if (bank_loss > worst_bank_loss) {
+                worst_bank_loss = bank_loss;
+            }
+        }
+        if (peak_bank < peak_single) {
+            passed = false;
+        }
+    }
+    cout << "Worst loss inside the bank: " << worst_bank_loss << " dB" << endl;
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,83 @@
+#include "pulseDetector.hpp"
+
+// Same three-real-filter coefficients as resource_opt3
+const fixed_point (&corrFilterBuff)[FILTER_LENGTH][3] = template_rom::value;
+
+template<int P>
+void matchFilter(hls::stream<complex_vec<P> >& RxSignal, hls::stream<real_vec<P> >& FilterOut) {
+    static_assert(SIGNAL_LENGTH % P == 0, "SIGNAL_LENGTH must be a multiple of P");
+
+    // One beat shifts P samples in, so lane p needs FILTER_LENGTH samples
+    // starting P-1-p entries into the delay line
+    const int BUFF_LENGTH = FILTER_LENGTH + P - 1;
+
+    complex_fixed_point dataBuff[BUFF_LENGTH];
+#pragma HLS ARRAY_PARTITION variable=dataBuff complete dim=1
+
+    for (int i = 0; i < BUFF_LENGTH; i++) {
+        dataBuff[i] = 0;
+    }
+
+    for (int i = 0; i < SIGNAL_LENGTH / P; i++) {
+#pragma HLS PIPELINE II=1
+        complex_vec<P> rx_beat = RxSignal.read();
+
+        // Shift the buffer by P, newest sample ends up in dataBuff[0]
+        for (int j = BUFF_LENGTH - 1; j >= P; j--) {
+            dataBuff[j] = dataBuff[j - P];
+        }
+        for (int p = 0; p < P; p++) {
+            dataBuff[P - 1 - p] = rx_beat.data[p];
+        }
+
+        // Lane p correlates the FILTER_LENGTH samples ending with its own
+        real_vec<P> out_beat;
+        for (int p = 0; p < P; p++) {
+            out_beat.data[p] = filter_arch::correlate<1>(&dataBuff[P - 1 - p], corrFilterBuff);
+        }
+        FilterOut.write(out_beat);
+    }
+    DETECTOR_PROBE_FRAME();
+}
+
+template<int P>
+void peakFinder(hls::stream<real_vec<P> >& FilterOut, fixed_point& peak, int& location) {
+    fixed_point current_peak = 0;
+    int current_location = 0;
+
+    for (int n = 0; n < SIGNAL_LENGTH / P; n++) {
+#pragma HLS PIPELINE II=1
+        real_vec<P> magBeat = FilterOut.read();
+
+        // P-lane argmax; the strict compare keeps the earliest lane on ties,
+        // matching the sample-serial peakFinder
+        fixed_point lane_peak = magBeat.data[0];
+        int lane = 0;
+        for (int p = 1; p < P; p++) {
+            if (magBeat.data[p] > lane_peak) {
+                lane_peak = magBeat.data[p];
+                lane = p;
+            }
+        }
+
+        if (lane_peak > current_peak) {
+            current_peak = lane_peak;
+            current_location = n * P + lane;
+        }
+    }
+
+    peak = current_peak;
+    location = current_location;
+}
+
+void pulseDetector(complex_vec_stream& RxSignal, fixed_point& peak, int& location) {
+#pragma HLS DATAFLOW
+    real_vec_stream FilterOut;
+#pragma HLS STREAM variable=FilterOut depth=4 dim=1
+
+    matchFilter<SSR_FACTOR>(RxSignal, FilterOut);
+    peakFinder<SSR_FACTOR>(FilterOut, peak, location);
+}
+
+// The testbench checks the filter output beat by beat
+template void matchFilter<SSR_FACTOR>(complex_vec_stream& RxSignal, real_vec_stream& FilterOut);
@@ -0,0 +1,59 @@
+#ifndef PULSE_DETECTOR_HPP
+#define PULSE_DETECTOR_HPP
+
+#include "../common/pulseDetectorCore.hpp"
+#include "../common/pulseDetectorTaps.hpp"
+#include "../common/pulseDetectorTemplate.hpp"
+
+// Define parameters (example) using macro definitions
+#define FILTER_LENGTH 64
+#define SIGNAL_LENGTH 5000
+
+// Super-sample-rate factor: samples carried by one stream beat (2, 4 or 8)
+#ifndef SSR_FACTOR
+#define SSR_FACTOR 4
+#endif
+
+// Detector instance: 18-bit fixed-point with 2 integer bits throughout, three
+// real filters with the template compiled in, one correlator per lane
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, ap_fixed<18, 2> > detector_cfg;
+typedef detector::three_real_mult<detector_cfg> filter_arch;
+
+// Define fixed-point data types
+typedef detector_cfg::data_t fixed_point;
+typedef detector_cfg::complex_t complex_fixed_point;
+
+// Define float data types
+typedef float float_point;
+typedef std::complex<float_point> complex_float_point;
+
+// Compiled-in template in the three-real form, built at compile time
+typedef detector::coeff::config_taps<detector_cfg, detector::recorded_template> template_taps;
+typedef detector::coeff::tap_rom<fixed_point, template_taps> template_rom;
+
+// Wide stream words holding P consecutive samples, oldest in data[0]
+template<int P>
+struct complex_vec {
+    complex_fixed_point data[P];
+};
+
+template<int P>
+struct real_vec {
+    fixed_point data[P];
+};
+
+typedef complex_vec<SSR_FACTOR> complex_vec_t;
+typedef real_vec<SSR_FACTOR> real_vec_t;
+
+// Define stream types
+typedef hls::stream<complex_vec_t> complex_vec_stream;
+typedef hls::stream<real_vec_t> real_vec_stream;
+
+// Function declarations
+template<int P>
+void matchFilter(hls::stream<complex_vec<P> >& RxSignal, hls::stream<real_vec<P> >& FilterOut);
+template<int P>
+void peakFinder(hls::stream<real_vec<P> >& FilterOut, fixed_point& peak, int& location);
+void pulseDetector(complex_vec_stream& RxSignal, fixed_point& peak, int& location);
+
+#endif
@@ -0,0 +1,120 @@
+#include "pulseDetector.hpp"
+#include "../common/iqCapture.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// Sample-serial three-real filter the lanes are checked against
+typedef detector::config<FILTER_LENGTH, SIGNAL_LENGTH, fixed_point> reference_cfg;
+typedef detector::three_real_mult<reference_cfg> reference_arch;
+
+int main() {
+    complex_vec_stream RxSignal;
+    complex_vec_t rx_beat;
+    complex_fixed_point rxSignalArray[SIGNAL_LENGTH];
+    fixed_point peak_hw;
+    int location_hw;
+    fixed_point peak_ref;
+    int location_ref;
+    int i;
+
+    // Read RxSignal from the binary capture, converted from RxSignal_in.txt on the
+    // first run, and pack SSR_FACTOR samples per beat
+    detector::iq_capture rx_capture;
+    if (!detector::openCapture(rx_capture, "RxSignal_in.iq", "RxSignal_in.txt", SIGNAL_LENGTH)) {
+        cerr << "Error opening RxSignal_in.iq" << endl;
+        return 1;
+    }
+    for (i = 0; i < SIGNAL_LENGTH && i < (int)rx_capture.numSamples(); i++) {
+        rxSignalArray[i] = rx_capture.sample<complex_fixed_point>(i);
+        rx_beat.data[i % SSR_FACTOR] = rxSignalArray[i];
+        if (i % SSR_FACTOR == SSR_FACTOR - 1) {
+            RxSignal.write(rx_beat);
+        }
+    }
+
+    // Run the pulse detector
+    pulseDetector(RxSignal, peak_hw, location_hw);
+
+    // Read reference peak from file
+    ifstream peak_file("peak_out.txt");
+    if (!peak_file.is_open()) {
+        cerr << "Error opening peak_out.txt" << endl;
+        return 1;
+    }
+    peak_file >> peak_ref;
+    peak_file.close();
+
+    // Read reference location from file
+    ifstream location_file("location_out.txt");
+    if (!location_file.is_open()) {
+        cerr << "Error opening location_out.txt" << endl;
+        return 1;
+    }
+    location_file >> location_ref;
+    location_file.close();
+
+    // Compare results
+    cout << "SSR Factor: " << SSR_FACTOR << endl;
+    cout << "Hardware Peak: " << peak_hw << ", Location: " << location_hw << endl;
+    cout << "Reference Peak: " << peak_ref << ", Location: " << location_ref << endl;
+
+    bool passed = (location_hw + 1 == location_ref);
+
+    // Every lane of every beat must match the sample-serial filter word for word
+    complex_vec_stream RxBeats;
+    real_vec_stream FilterOut;
+    reference_cfg::complex_stream RxSerial;
+    reference_cfg::real_stream RefOut;
+    for (i = 0; i < SIGNAL_LENGTH; i++) {
+        rx_beat.data[i % SSR_FACTOR] = rxSignalArray[i];
+        if (i % SSR_FACTOR == SSR_FACTOR - 1) {
+            RxBeats.write(rx_beat);
+        }
+        RxSerial.write(rxSignalArray[i]);
+    }
+    matchFilter<SSR_FACTOR>(RxBeats, FilterOut);
+    detector::matchFilter<reference_cfg, reference_arch>(RxSerial, template_rom::value, RefOut);
+
+    int mismatches = 0;
+    for (i = 0; i < SIGNAL_LENGTH / SSR_FACTOR; i++) {
+        real_vec_t out_beat = FilterOut.read();
+        for (int p = 0; p < SSR_FACTOR; p++) {
+            fixed_point ref = RefOut.read();
+            if (out_beat.data[p] != ref) {
+                if (mismatches < 10) {
+                    cout << "Mismatch at sample " << i * SSR_FACTOR + p << ": " << out_beat.data[p] << " vs " << ref << endl;
+                }
+                mismatches++;
+            }
+        }
+    }
+    cout << "Filter output mismatches: " << mismatches << endl;
+    if (mismatches != 0) {
+        passed = false;
+    }
+
+#if DETECTOR_PROBES_ENABLED
+    // Every lane goes through the shared correlator probes; none may wrap
+    const detector::probe::registry& probes = detector::probe::registry::instance();
+    for (int n = 0; n < probes.numNodes(); n++) {
+        if (probes[n].wraps != 0) {
+            cout << "Node " << probes[n].name << " wrapped " << probes[n].wraps << " times" << endl;
+            passed = false;
+        }
+    }
+    if (probes.find("conv_plus") == NULL || probes.find("mag") == NULL || probes.numFrames() == 0) {
+        passed = false;
+    }
+#endif
+
+    if (passed) {
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test failed!" << endl;
+        return 1;
+    }
+}